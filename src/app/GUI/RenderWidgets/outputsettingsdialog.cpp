@@ -83,6 +83,10 @@ OutputSettingsDialog::OutputSettingsDialog(const OutputSettings &settings,
     mBitrateSpinBox = new QDoubleSpinBox(this);
     mBitrateSpinBox->setRange(0.1, 100.);
     mBitrateSpinBox->setSuffix(" Mbps");
+    mVideoThreadsLabel = new QLabel("Threads:", this);
+    mVideoThreadsSpinBox = new QSpinBox(this);
+    mVideoThreadsSpinBox->setRange(0, 64);
+    mVideoThreadsSpinBox->setSpecialValueText("Auto");
 
     mVideoSettingsLayout->addPair(mVideoCodecsLabel,
                                   mVideoCodecsComboBox);
@@ -90,6 +94,8 @@ OutputSettingsDialog::OutputSettingsDialog(const OutputSettings &settings,
                                   mPixelFormatsComboBox);
     mVideoSettingsLayout->addPair(mBitrateLabel,
                                   mBitrateSpinBox);
+    mVideoSettingsLayout->addPair(mVideoThreadsLabel,
+                                  mVideoThreadsSpinBox);
 
     mAudioGroupBox = new QGroupBox("Audio", this);
     mAudioGroupBox->setCheckable(true);
@@ -191,6 +197,7 @@ OutputSettings OutputSettingsDialog::getSettings() {
     }
     settings.fVideoPixelFormat = currentPixelFormat;
     settings.fVideoBitrate = qRound(mBitrateSpinBox->value()*1000000);
+    settings.fVideoThreads = mVideoThreadsSpinBox->value();
 
     settings.fAudioEnabled = mAudioGroupBox->isChecked();
     const AVCodec *currentAudioCodec = nullptr;
@@ -605,6 +612,7 @@ void OutputSettingsDialog::restoreInitialSettings() {
     } else {
         mBitrateSpinBox->setValue(currentBitrate/1000000.);
     }
+    mVideoThreadsSpinBox->setValue(mInitialSettings.fVideoThreads);
     const bool noVideoCodecs = mVideoCodecsComboBox->count() == 0;
     mVideoGroupBox->setChecked(mInitialSettings.fVideoEnabled &&
                                !noVideoCodecs);
@@ -90,6 +90,8 @@ protected:
     QComboBox *mPixelFormatsComboBox = nullptr;
     QLabel *mBitrateLabel = nullptr;
     QDoubleSpinBox *mBitrateSpinBox = nullptr;
+    QLabel *mVideoThreadsLabel = nullptr;
+    QSpinBox *mVideoThreadsSpinBox = nullptr;
 
     QGroupBox *mAudioGroupBox = nullptr;
     TwoColumnLayout *mAudioSettingsLayout = nullptr;
@@ -43,25 +43,7 @@ RenderInstanceWidget::RenderInstanceWidget(const RenderInstanceSettings& sett,
 }
 
 void RenderInstanceWidget::iniGUI() {
-    if(!OutputSettingsProfile::sOutputProfilesLoaded) {
-        OutputSettingsProfile::sOutputProfilesLoaded = true;
-        QDir(eSettings::sSettingsDir()).mkdir("OutputProfiles");
-        const QString dirPath = eSettings::sSettingsDir() + "/OutputProfiles";
-        QDirIterator dirIt(dirPath, QDirIterator::NoIteratorFlags);
-        while(dirIt.hasNext()) {
-            const auto path = dirIt.next();
-            const QFileInfo fileInfo(path);
-            if(!fileInfo.isFile()) continue;
-            if(!fileInfo.completeSuffix().contains("eProf")) continue;
-            const auto profile = enve::make_shared<OutputSettingsProfile>();
-            try {
-                profile->load(path);
-            } catch(const std::exception& e) {
-                gPrintExceptionCritical(e);
-            }
-            OutputSettingsProfile::sOutputProfiles << profile;
-        }
-    }
+    OutputSettingsProfile::sLoadProfiles();
 
     setCheckable(true);
     setObjectName("darkWidget");
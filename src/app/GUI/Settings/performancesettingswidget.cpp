@@ -82,6 +82,52 @@ PerformanceSettingsWidget::PerformanceSettingsWidget(QWidget *parent) :
     mPathGpuAccCheck = new QCheckBox("Path GPU acceleration", this);
     addWidget(mPathGpuAccCheck);
 
+    mFuseCpuEffectsCheck = new QCheckBox("Fuse CPU raster effects", this);
+    const QString fuseCpuEffectsTip =
+            "Apply consecutive per-pixel effects in a single pass";
+    mFuseCpuEffectsCheck->setToolTip(gSingleLineTooltip(fuseCpuEffectsTip));
+    addWidget(mFuseCpuEffectsCheck);
+
+    addSeparator();
+
+    const auto framesInFlightSett = new QHBoxLayout;
+    const auto framesInFlightLabel = new QLabel("Output frames in flight", this);
+    mOutputFramesInFlightSpin = new QSpinBox(this);
+    mOutputFramesInFlightSpin->setRange(1, 4*HardwareInfo::sCpuThreads());
+    const QString framesInFlightTip =
+            "Number of output frames rendered simultaneously";
+    framesInFlightLabel->setToolTip(gSingleLineTooltip(framesInFlightTip));
+    mOutputFramesInFlightSpin->setToolTip(gSingleLineTooltip(framesInFlightTip));
+    framesInFlightSett->addWidget(framesInFlightLabel);
+    framesInFlightSett->addWidget(mOutputFramesInFlightSpin);
+    addLayout(framesInFlightSett);
+
+    const auto hddThreadsSett = new QHBoxLayout;
+    const auto hddThreadsLabel = new QLabel("HDD threads", this);
+    mHddThreadsSpin = new QSpinBox(this);
+    mHddThreadsSpin->setRange(1, 16);
+    const QString hddThreadsTip =
+            "Number of threads reading media and cache from the drive, "
+            "takes effect after restart";
+    hddThreadsLabel->setToolTip(gSingleLineTooltip(hddThreadsTip));
+    mHddThreadsSpin->setToolTip(gSingleLineTooltip(hddThreadsTip));
+    hddThreadsSett->addWidget(hddThreadsLabel);
+    hddThreadsSett->addWidget(mHddThreadsSpin);
+    addLayout(hddThreadsSett);
+
+    const auto audioLookAheadSett = new QHBoxLayout;
+    const auto audioLookAheadLabel = new QLabel("Audio look-ahead", this);
+    mAudioLookAheadSpin = new QSpinBox(this);
+    mAudioLookAheadSpin->setRange(0, 30);
+    mAudioLookAheadSpin->setSuffix(" s");
+    const QString audioLookAheadTip =
+            "Seconds of sound prepared ahead of the playback position";
+    audioLookAheadLabel->setToolTip(gSingleLineTooltip(audioLookAheadTip));
+    mAudioLookAheadSpin->setToolTip(gSingleLineTooltip(audioLookAheadTip));
+    audioLookAheadSett->addWidget(audioLookAheadLabel);
+    audioLookAheadSett->addWidget(mAudioLookAheadSpin);
+    addLayout(audioLookAheadSett);
+
 //    const auto line2 = new QFrame();
 //    line2->setFrameShape(QFrame::HLine);
 //    line2->setFrameShadow(QFrame::Sunken);
@@ -117,6 +163,10 @@ void PerformanceSettingsWidget::applySettings() {
     mSett.fAccPreference = static_cast<AccPreference>(
                 mAccPreferenceSlider->value());
     mSett.fPathGpuAcc = mPathGpuAccCheck->isChecked();
+    mSett.fFuseCpuEffects = mFuseCpuEffectsCheck->isChecked();
+    mSett.fOutputFramesInFlight = mOutputFramesInFlightSpin->value();
+    mSett.fHddThreads = mHddThreadsSpin->value();
+    mSett.fAudioLookAheadSeconds = mAudioLookAheadSpin->value();
 //        sett.fHddCache = mHddCacheCheck->isChecked();
 //        sett.fRamMBCap = mHddCacheMBCapCheck->isChecked() ?
 //                    mHddCacheMBCapSpin->value() : 0;
@@ -139,6 +189,10 @@ void PerformanceSettingsWidget::updateSettings() {
     mAccPreferenceSlider->setValue(static_cast<int>(mSett.fAccPreference));
     updateAccPreferenceDesc();
     mPathGpuAccCheck->setChecked(mSett.fPathGpuAcc);
+    mFuseCpuEffectsCheck->setChecked(mSett.fFuseCpuEffects);
+    mOutputFramesInFlightSpin->setValue(mSett.fOutputFramesInFlight);
+    mHddThreadsSpin->setValue(mSett.fHddThreads);
+    mAudioLookAheadSpin->setValue(mSett.fAudioLookAheadSeconds);
 
 //    mHddCacheCheck->setChecked(sett.fHddCache);
 
@@ -31,6 +31,11 @@ private:
     QLabel* mAccPreferenceGpuLabel = nullptr;
 
     QCheckBox* mPathGpuAccCheck = nullptr;
+    QCheckBox* mFuseCpuEffectsCheck = nullptr;
+
+    QSpinBox* mOutputFramesInFlightSpin = nullptr;
+    QSpinBox* mHddThreadsSpin = nullptr;
+    QSpinBox* mAudioLookAheadSpin = nullptr;
 
     QCheckBox* mHddCacheCheck = nullptr;
 
@@ -79,14 +79,17 @@ void AudioHandler::initializeAudio(eSoundSettingsData& soundSettings) {
 }
 
 void AudioHandler::startAudio() {
+    if(!mAudioOutput) return;
     mAudioIOOutput = mAudioOutput->start();
 }
 
 void AudioHandler::pauseAudio() {
+    if(!mAudioOutput) return;
     mAudioOutput->suspend();
 }
 
 void AudioHandler::resumeAudio() {
+    if(!mAudioOutput) return;
     mAudioOutput->resume();
 }
 
@@ -94,6 +97,7 @@ void AudioHandler::stopAudio() {
     //mAudioOutput->suspend();
     //mCurrentSoundComposition->stop();
     mAudioIOOutput = nullptr;
+    if(!mAudioOutput) return;
     mAudioOutput->stop();
     mAudioOutput->reset();
 }
@@ -837,6 +837,11 @@ void MainWindow::setupStatusBar() {
     mUsageWidget = new UsageWidget(this);
     mUsageWidget->setStyleSheet("QStatusBar { border-top: 1px solid black; }");
     setStatusBar(mUsageWidget);
+    connect(MemoryHandler::sInstance, &MemoryHandler::memoryUsageChanged,
+            mUsageWidget, [this](const qreal usedMB, const qreal totalMB) {
+        mUsageWidget->setTotalRam(totalMB);
+        mUsageWidget->setRamUsage(usedMB);
+    });
 }
 
 void MainWindow::setupToolBar() {
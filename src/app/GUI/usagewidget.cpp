@@ -19,6 +19,11 @@
 #include "GUI/global.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/complextask.h"
+#include "Private/Tasks/taskexecutor.h"
+#include "CacheHandlers/tmpsaver.h"
+#include "CacheHandlers/tmploader.h"
+#include "Boxes/layerboxrenderdata.h"
+#include "skia/pixelbufferpool.h"
 #include "conncontextptr.h"
 
 #include <QTimer>
@@ -193,6 +198,54 @@ void UsageWidget::setRamUsage(const qreal thisMB) {
     mGpuBar->popAllButLast();
     mCpuBar->popAllButLast();
     mHddBar->popAllButLast();
+    updateCpuWorkerStats();
+    updateHddThroughput();
+    updatePixelPoolStats();
+}
+
+void UsageWidget::updateCpuWorkerStats() {
+    const auto stats = CpuTaskExecutor::sWorkerStats();
+    const qint64 composited = ContainerBoxRenderData::sFramePixelsComposited;
+    QString toolTip = QString("re-composited last frame: %1 px\n").
+            arg(composited);
+    toolTip += "worker: queued / processed / steals / idle";
+    for(int i = 0; i < stats.count(); i++) {
+        const auto& worker = stats.at(i);
+        toolTip += QString("\n%1: %2 / %3 / %4 / %5 s").
+                arg(i).arg(worker.fQueued).
+                arg(worker.fProcessed).arg(worker.fSteals).
+                arg(worker.fIdleMs/1000.);
+    }
+    mCpuBar->setToolTip(toolTip);
+}
+
+void UsageWidget::updateHddThroughput() {
+    const qint64 written = TmpSaver::sBytesWritten;
+    const qint64 read = TmpLoader::sBytesRead;
+    if(mHddTimer.isValid()) {
+        const qreal secs = qMax(1, int(mHddTimer.restart()))/1000.;
+        const qreal mb = 1024*1024;
+        const qreal writeMBs = (written - mLastBytesWritten)/mb/secs;
+        const qreal readMBs = (read - mLastBytesRead)/mb/secs;
+        mHddBar->setToolTip(QString("cache write: %1 MB/s\n"
+                                    "cache read: %2 MB/s").
+                            arg(writeMBs, 0, 'f', 1).
+                            arg(readMBs, 0, 'f', 1));
+    } else mHddTimer.start();
+    mLastBytesWritten = written;
+    mLastBytesRead = read;
+}
+
+void UsageWidget::updatePixelPoolStats() {
+    const auto stats = PixelBufferPool::sStats();
+    const qreal mb = 1024*1024;
+    const qint64 total = stats.fReused + stats.fAllocated;
+    const qreal reusedPerc = total > 0 ? 100.*stats.fReused/total : 0;
+    mRamBar->setToolTip(QString("pixel pool: %1 MB\n"
+                                "reused allocations: %2% (%3 MB)").
+                        arg(stats.fPooledBytes/mb, 0, 'f', 1).
+                        arg(reusedPerc, 0, 'f', 1).
+                        arg(stats.fReusedBytes/mb, 0, 'f', 1));
 }
 
 void UsageWidget::setTotalRam(const qreal totalRamMB) {
@@ -20,6 +20,7 @@
 #include <QLabel>
 #include <QThread>
 #include <QStatusBar>
+#include <QElapsedTimer>
 
 class HardwareUsageWidget;
 class ComplexTaskWidget;
@@ -37,11 +38,18 @@ public:
 
     void addComplexTask(ComplexTask* const task);
 private:
+    void updateCpuWorkerStats();
+    void updateHddThroughput();
+    void updatePixelPoolStats();
+
     HardwareUsageWidget* mGpuBar;
     HardwareUsageWidget* mCpuBar;
     HardwareUsageWidget* mHddBar;
     HardwareUsageWidget* mRamBar;
     QLabel* mRamLabel;
+    QElapsedTimer mHddTimer;
+    qint64 mLastBytesWritten = 0;
+    qint64 mLastBytesRead = 0;
     QList<ComplexTaskWidget*> mTaskWidgets;
 };
 
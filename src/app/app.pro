@@ -154,6 +154,7 @@ SOURCES += main.cpp\
     execdelegator.cpp \
     GUI/BoxesList/boxscrollarea.cpp \
     videoencoder.cpp \
+    imagesequencewriter.cpp \
     GUI/RenderWidgets/outputsettingsprofilesdialog.cpp \
     GUI/RenderWidgets/outputsettingsdisplaywidget.cpp \
     GUI/actionbutton.cpp \
@@ -282,6 +283,7 @@ HEADERS  += \
     execdelegator.h \
     GUI/BoxesList/boxscrollarea.h \
     videoencoder.h \
+    imagesequencewriter.h \
     GUI/RenderWidgets/outputsettingsprofilesdialog.h \
     GUI/RenderWidgets/outputsettingsdisplaywidget.h \
     GUI/actionbutton.h \
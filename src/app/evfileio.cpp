@@ -86,7 +86,12 @@ void MainWindow::loadEVFile(const QString &path) {
                     scene->readSettings(readStream);
                 }
             }
-            mLayoutHandler->read(readStream);
+            if(evVersion >= EvFormat::framedLayout) {
+                const qint64 layoutEnd = readStream.readFrameBegin(
+                            "Error reading Layout");
+                mLayoutHandler->read(readStream);
+                readStream.readFrameEnd(layoutEnd, "Error reading Layout");
+            } else mLayoutHandler->read(readStream);
             readStream.readCheckpoint("Error reading Layout");
         }
         mDocument.readScenes(readStream);
@@ -119,7 +124,10 @@ void MainWindow::saveToFile(const QString &path) {
         for(const auto& scene : scenes) {
             scene->writeSettings(writeStream);
         }
+        // framed so that readers without the gui can skip it
+        const qint64 layoutFrame = writeStream.beginFrame();
         mLayoutHandler->write(writeStream);
+        writeStream.endFrame(layoutFrame);
         writeStream.writeCheckpoint();
         mDocument.writeScenes(writeStream);
         writeStream.writeCheckpoint();
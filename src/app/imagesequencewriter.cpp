@@ -0,0 +1,115 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "imagesequencewriter.h"
+
+#include <QFile>
+#include <QImage>
+#include <QImageWriter>
+#include "skia/skiahelpers.h"
+
+ImageSequenceFrameWriter::ImageSequenceFrameWriter(
+        const sk_sp<SkImage>& image, const QStringList& paths,
+        const Format format, const bool sixteenBit,
+        const bool alpha, const Done& done) :
+    mImage(image), mPaths(paths), mFormat(format),
+    mSixteenBit(sixteenBit), mAlpha(alpha), mDone(done) {}
+
+void ImageSequenceFrameWriter::process() {
+    if(mPaths.isEmpty()) return;
+    const QString& first = mPaths.first();
+    if(mFormat == Format::tiff) writeQt(first);
+    else writeSkia(first);
+    for(int i = 1; i < mPaths.count(); i++) {
+        const QString& path = mPaths.at(i);
+        if(QFile::exists(path) && !QFile::remove(path))
+            RuntimeThrow("Could not overwrite " + path);
+        if(!QFile::copy(first, path))
+            RuntimeThrow("Could not copy " + first + " to " + path);
+    }
+}
+
+void ImageSequenceFrameWriter::writeSkia(const QString& path) {
+    const auto format = mFormat == Format::png ? SkEncodedImageFormat::kPNG :
+                                                 SkEncodedImageFormat::kJPEG;
+    const bool alpha = mAlpha && mFormat == Format::png;
+    if(mSixteenBit && mFormat == Format::png) {
+        const auto info = mImage->imageInfo().
+                makeColorType(kRGBA_F16_SkColorType).
+                makeAlphaType(alpha ? kPremul_SkAlphaType :
+                                      kOpaque_SkAlphaType);
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        if(!mImage->readPixels(bitmap.pixmap(), 0, 0))
+            RuntimeThrow("Could not convert frame to 16 bits");
+        const auto img = SkiaHelpers::transferDataToSkImage(bitmap);
+        SkiaHelpers::saveImage(path, img, format, 100);
+        return;
+    }
+    if(alpha) {
+        SkiaHelpers::saveImage(path, mImage, format, 100);
+    } else {
+        // encode straight from the frame pixels, ignoring alpha
+        SkPixmap pixmap;
+        if(!mImage->peekPixels(&pixmap)) RuntimeThrow("Frame not in memory");
+        const SkPixmap opaque(pixmap.info().makeAlphaType(kOpaque_SkAlphaType),
+                              pixmap.addr(), pixmap.rowBytes());
+        const auto img = SkImage::MakeFromRaster(opaque, nullptr, nullptr);
+        SkiaHelpers::saveImage(path, img, format, 100);
+    }
+}
+
+void ImageSequenceFrameWriter::writeQt(const QString& path) {
+    SkPixmap pixmap;
+    if(!mImage->peekPixels(&pixmap)) RuntimeThrow("Frame not in memory");
+    // wraps the frame pixels without copying
+    const QImage frame(static_cast<const uchar*>(pixmap.addr()),
+                       pixmap.width(), pixmap.height(),
+                       int(pixmap.rowBytes()),
+                       QImage::Format_RGBA8888_Premultiplied);
+    QImage::Format format;
+    if(mSixteenBit) {
+        format = mAlpha ? QImage::Format_RGBA64 : QImage::Format_RGBX64;
+    } else {
+        format = mAlpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888;
+    }
+    QImageWriter writer(path, "tiff");
+    if(!writer.write(frame.convertToFormat(format))) {
+        RuntimeThrow("Could not write " + path + ".\n" +
+                     writer.errorString());
+    }
+}
+
+void ImageSequenceFrameWriter::afterProcessing() {
+    if(mDone) mDone(QString());
+}
+
+void ImageSequenceFrameWriter::afterCanceled() {
+    if(mDone) mDone("Canceled");
+}
+
+bool ImageSequenceFrameWriter::handleException() {
+    QString error;
+    try {
+        std::rethrow_exception(takeException());
+    } catch(const std::exception& e) {
+        error = gAllTextFromException(e);
+    } catch(...) {
+        error = "Failed to write " + mPaths.join(", ");
+    }
+    if(mDone) mDone(error);
+    return true;
+}
@@ -0,0 +1,57 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef IMAGESEQUENCEWRITER_H
+#define IMAGESEQUENCEWRITER_H
+#include <QStringList>
+#include "Tasks/updatable.h"
+#include "skia/skiaincludes.h"
+
+//! @brief Compresses a frame once and saves it under all of its paths,
+//! a cache container can cover several identical frames.
+class ImageSequenceFrameWriter : public eCpuTask {
+    e_OBJECT
+public:
+    enum class Format { png, tiff, jpeg };
+    //! @brief Called on the main thread, error is empty on success.
+    using Done = std::function<void(const QString& error)>;
+protected:
+    ImageSequenceFrameWriter(const sk_sp<SkImage>& image,
+                             const QStringList& paths,
+                             const Format format,
+                             const bool sixteenBit,
+                             const bool alpha,
+                             const Done& done);
+public:
+    void beforeProcessing(const Hardware) {}
+    void process();
+protected:
+    void afterProcessing();
+    void afterCanceled();
+    bool handleException();
+private:
+    void writeSkia(const QString& path);
+    void writeQt(const QString& path);
+
+    const sk_sp<SkImage> mImage;
+    const QStringList mPaths;
+    const Format mFormat;
+    const bool mSixteenBit;
+    const bool mAlpha;
+    const Done mDone;
+};
+
+#endif // IMAGESEQUENCEWRITER_H
@@ -16,9 +16,8 @@
 
 #include "memoryhandler.h"
 #include "Boxes/boxrendercontainer.h"
-#include "GUI/mainwindow.h"
+#include "skia/pixelbufferpool.h"
 #include <QMetaType>
-#include "GUI/usagewidget.h"
 
 #ifdef Q_OS_MAC
 #include <malloc/malloc.h>
@@ -86,10 +85,14 @@ void MemoryHandler::freeMemory(const MemoryState newState,
 
     if(minFreeBytes.fValue <= 0) return;
     qint64 memToFree = minFreeBytes.fValue;
-    while(memToFree > 0 && !mDataHandler.isEmpty()) {
-        const auto cont = mDataHandler.takeFirst();
+    memToFree -= PixelBufferPool::sClear();
+    while(memToFree > 0) {
+        const auto cont = mDataHandler.takeNextToFree();
+        if(!cont) break;
         memToFree -= cont->free_RAM_k();
     }
+    // pixels of the freed containers were returned to the pool
+    PixelBufferPool::sClear();
     if(newState == CRITICAL_MEMORY_STATE) {
         emit enteredCriticalState();
         emit allMemoryUsed();
@@ -100,10 +103,6 @@ void MemoryHandler::freeMemory(const MemoryState newState,
 }
 
 void MemoryHandler::memoryChecked(const intKB memKb, const intKB totMemKb) {
-    const auto window = MainWindow::sGetInstance();
-    if(!window) return;
-    const auto usageWidget = window->getUsageWidget();
-    if(!usageWidget) return;
-    usageWidget->setTotalRam(totMemKb.fValue/qreal(1024));
-    usageWidget->setRamUsage((totMemKb - memKb).fValue/qreal(1024));
+    emit memoryUsageChanged((totMemKb - memKb).fValue/qreal(1024),
+                            totMemKb.fValue/qreal(1024));
 }
@@ -34,6 +34,8 @@ signals:
 
     void enteredCriticalState();
     void finishedCriticalState();
+
+    void memoryUsageChanged(qreal usedMB, qreal totalMB);
 private:
     void freeMemory(const MemoryState newState, const longB &minFreeBytes);
     void memoryChecked(const intKB memKb, const intKB totMemKb);
@@ -15,6 +15,9 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "outputsettings.h"
+#include "ReadWrite/evformat.h"
+
+#include <QDirIterator>
 
 QList<qsptr<OutputSettingsProfile>> OutputSettingsProfile::sOutputProfiles;
 bool OutputSettingsProfile::sOutputProfilesLoaded = false;
@@ -99,6 +102,14 @@ uint64_t OutputSettings::sGetChannelsLayout(const QString &name) {
     return AV_CH_LAYOUT_STEREO;
 }
 
+bool OutputSettings::isImageSequence() const {
+    if(!fVideoEnabled || !fOutputFormat || !fVideoCodec) return false;
+    if(strcmp(fOutputFormat->name, "image2")) return false;
+    const auto id = fVideoCodec->id;
+    return id == AV_CODEC_ID_PNG || id == AV_CODEC_ID_TIFF ||
+           id == AV_CODEC_ID_MJPEG;
+}
+
 void OutputSettings::write(eWriteStream &dst) const {
     dst << (fOutputFormat ? QString(fOutputFormat->name) : "");
 
@@ -106,6 +117,7 @@ void OutputSettings::write(eWriteStream &dst) const {
     dst << (fVideoCodec ? fVideoCodec->id : -1);
     dst.write(&fVideoPixelFormat, sizeof(AVPixelFormat));
     dst << fVideoBitrate;
+    dst << fVideoThreads;
 
     dst << fAudioEnabled;
     dst << (fAudioCodec ? fAudioCodec->id : -1);
@@ -126,6 +138,8 @@ void OutputSettings::read(eReadStream &src) {
     fVideoCodec = avcodec_find_encoder(avVideoCodecId);
     src.read(&fVideoPixelFormat, sizeof(AVPixelFormat));
     src >> fVideoBitrate;
+    if(src.evFileVersion() >= EvFormat::videoEncoderThreads)
+        src >> fVideoThreads;
 
     src >> fAudioEnabled;
     int audioCodecId; src >> audioCodecId;
@@ -171,6 +185,9 @@ void OutputSettingsProfile::save() {
 
             stream << "Video bitrate: ";
             stream << QString::number(mSettings.fVideoBitrate) << endl;
+
+            stream << "Video threads: ";
+            stream << QString::number(mSettings.fVideoThreads) << endl;
         }
 
         stream << "Audio enabled: ";
@@ -228,6 +245,8 @@ void OutputSettingsProfile::load(const QString &path) {
                             val.toUtf8().data());
             } else if(var == "Video bitrate") {
                 mSettings.fVideoBitrate = val.toInt();
+            } else if(var == "Video threads") {
+                mSettings.fVideoThreads = val.toInt();
             } else if(var == "Audio enabled") {
                 mSettings.fAudioEnabled = (val == "true");
             } else if(var == "Audio codec") {
@@ -256,6 +275,27 @@ void OutputSettingsProfile::removeFile() {
     QFile(mPath).remove();
 }
 
+void OutputSettingsProfile::sLoadProfiles() {
+    if(sOutputProfilesLoaded) return;
+    sOutputProfilesLoaded = true;
+    QDir(eSettings::sSettingsDir()).mkdir("OutputProfiles");
+    const QString dirPath = eSettings::sSettingsDir() + "/OutputProfiles";
+    QDirIterator dirIt(dirPath, QDirIterator::NoIteratorFlags);
+    while(dirIt.hasNext()) {
+        const auto path = dirIt.next();
+        const QFileInfo fileInfo(path);
+        if(!fileInfo.isFile()) continue;
+        if(!fileInfo.completeSuffix().contains("eProf")) continue;
+        const auto profile = enve::make_shared<OutputSettingsProfile>();
+        try {
+            profile->load(path);
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+        }
+        sOutputProfiles << profile;
+    }
+}
+
 OutputSettingsProfile *OutputSettingsProfile::sGetByName(const QString &name) {
     for(const auto& profile : sOutputProfiles) {
         if(profile->getName() == name) return profile.get();
@@ -39,12 +39,17 @@ struct OutputSettings {
     void write(eWriteStream& dst) const;
     void read(eReadStream& src);
 
+    //! @brief Frames written as separate files by ImageSequenceFrameWriter
+    //! instead of going through the muxer.
+    bool isImageSequence() const;
+
     const AVOutputFormat *fOutputFormat = nullptr;
 
     bool fVideoEnabled = false;
     const AVCodec *fVideoCodec = nullptr;
     AVPixelFormat fVideoPixelFormat = AV_PIX_FMT_NONE;
     int fVideoBitrate = 0;
+    int fVideoThreads = 0; // 0 - automatic
 
     bool fAudioEnabled = false;
     const AVCodec *fAudioCodec = nullptr;
@@ -74,6 +79,7 @@ public:
     const QString& path() const { return mPath; }
 
     static OutputSettingsProfile* sGetByName(const QString& name);
+    static void sLoadProfiles();
     static QList<qsptr<OutputSettingsProfile>> sOutputProfiles;
     static bool sOutputProfilesLoaded;
 signals:
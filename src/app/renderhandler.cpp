@@ -23,6 +23,7 @@
 #include "CacheHandlers/soundcachecontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "Private/document.h"
+#include "Private/esettings.h"
 
 RenderHandler* RenderHandler::sInstance = nullptr;
 
@@ -45,8 +46,10 @@ RenderHandler::RenderHandler(Document &document,
             this, &RenderHandler::nextPreviewFrame);
     connect(mPreviewFPSTimer, &QTimer::timeout,
             this, &RenderHandler::audioPushTimerExpired);
-    connect(audioHandler.audioOutput(), &QAudioOutput::notify,
-            this, &RenderHandler::audioPushTimerExpired);
+    if(const auto audioOutput = audioHandler.audioOutput()) {
+        connect(audioOutput, &QAudioOutput::notify,
+                this, &RenderHandler::audioPushTimerExpired);
+    }
 
     const auto vidEmitter = videoEncoder.getEmitter();
 //    connect(vidEmitter, &VideoEncoderEmitter::encodingStarted,
@@ -59,6 +62,8 @@ RenderHandler::RenderHandler(Document &document,
             this, &RenderHandler::interruptOutputRendering);
     connect(vidEmitter, &VideoEncoderEmitter::encodingStartFailed,
             this, &RenderHandler::interruptOutputRendering);
+    connect(vidEmitter, &VideoEncoderEmitter::framesEncoded,
+            this, &RenderHandler::encoderQueueFreed);
 }
 
 void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings) {
@@ -68,6 +73,7 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
         mSavedResolutionFraction = mCurrentScene->getResolution();
 
         mCurrentRenderSettings = settings;
+        mEncoderStalled = false;
         const auto &renderSettings = settings->getRenderSettings();
         setFrameAction(renderSettings.fMinFrame);
 
@@ -103,7 +109,7 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
             mCurrentScene->setResolution(resolutionFraction);
             mDocument.actionFinished();
         } else {
-            nextCurrentRenderFrame();
+            nextCurrentRenderFrames();
             if(TaskScheduler::sAllQuedCpuTasksFinished()) {
                 nextSaveOutputFrame();
             }
@@ -142,6 +148,23 @@ void RenderHandler::nextCurrentRenderFrame() {
     else setFrameAction(mCurrentRenderFrame);
 }
 
+bool RenderHandler::nextCurrentRenderFrames() {
+    const int inFlight = eSettings::sInstance->fOutputFramesInFlight;
+    if(inFlight <= 1) {
+        nextCurrentRenderFrame();
+        return true;
+    }
+    // frames from mCurrentEncodeFrame up to mCurrentRenderFrame
+    // are either being rendered or waiting to be handed to the encoder
+    bool advanced = false;
+    while(mCurrentRenderFrame < mMaxRenderFrame &&
+          mCurrentRenderFrame - mCurrentEncodeFrame + 1 < inFlight) {
+        nextCurrentRenderFrame();
+        advanced = true;
+    }
+    return advanced;
+}
+
 void RenderHandler::setPreviewState(const PreviewSate state) {
     if(mPreviewSate == state) return;
     if(mPreviewSate == PreviewSate::stopped) {
@@ -215,6 +238,7 @@ void RenderHandler::interruptPreviewRendering() {
 }
 
 void RenderHandler::interruptOutputRendering() {
+    mEncoderStalled = false;
     if(mCurrentScene) mCurrentScene->setOutputRendering(false);
     TaskScheduler::instance()->setAlwaysQue(false);
     TaskScheduler::sClearAllFinishedFuncs();
@@ -324,6 +348,7 @@ void RenderHandler::nextPreviewFrame() {
 void RenderHandler::finishEncoding() {
     TaskScheduler::sClearAllFinishedFuncs();
     mCurrentRenderSettings = nullptr;
+    mEncoderStalled = false;
     mCurrentScene->setOutputRendering(false);
     TaskScheduler::instance()->setAlwaysQue(false);
     setFrameAction(mSavedCurrentFrame);
@@ -377,15 +402,26 @@ void RenderHandler::nextSaveOutputFrame() {
                 finishEncoding();
             });
         }
+    } else if(VideoEncoder::sQueueFull()) {
+        // wait for the encoder thread, resumed in encoderQueueFreed
+        mEncoderStalled = true;
     } else {
+        mEncoderStalled = false;
         mCurrentRenderSettings->setCurrentRenderFrame(mCurrentRenderFrame);
-        nextCurrentRenderFrame();
+        const bool advanced = nextCurrentRenderFrames();
         if(TaskScheduler::sAllTasksFinished()) {
+            if(!advanced) nextCurrentRenderFrame();
             nextSaveOutputFrame();
         }
     }
 }
 
+void RenderHandler::encoderQueueFreed() {
+    if(!mEncoderStalled || !mCurrentRenderSettings) return;
+    if(VideoEncoder::sQueueFull()) return;
+    nextSaveOutputFrame();
+}
+
 void RenderHandler::startAudio() {
     mAudioHandler.startAudio();
     if(mCurrentSoundComposition)
@@ -72,9 +72,11 @@ private:
     void playPreviewAfterAllTasksCompleted();
 
     void nextSaveOutputFrame();
+    void encoderQueueFreed();
     void nextPreviewRenderFrame();
     void nextPreviewFrame();
     void nextCurrentRenderFrame();
+    bool nextCurrentRenderFrames();
 
     void setPreviewState(const PreviewSate state);
     void setRenderingPreview(const bool rendering);
@@ -117,6 +119,8 @@ private:
     int mCurrentRenderFrame;
     int mMinRenderFrame = 0;
     int mMaxRenderFrame = 0;
+    //! @brief true if rendering waits for space in the encoder queue
+    bool mEncoderStalled = false;
 
     int mSavedCurrentFrame = 0;
     qreal mSavedResolutionFraction = 100;
@@ -16,9 +16,17 @@
 
 #include "videoencoder.h"
 #include <QByteArray>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <condition_variable>
 #include "Boxes/boxrendercontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "canvas.h"
+#include "imagesequencewriter.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "Private/Tasks/taskexecutor.h"
+#include "Private/esettings.h"
 
 #define AV_RuntimeThrow(errId, message) \
 { \
@@ -37,23 +45,81 @@ VideoEncoder *VideoEncoder::sInstance = nullptr;
 VideoEncoder::VideoEncoder() {
     Q_ASSERT(!sInstance);
     sInstance = this;
+    QObject::connect(&mEmitter, &VideoEncoderEmitter::framesEncoded,
+                     &mEmitter, [this]() { updateEncodedFrame(); },
+                     Qt::QueuedConnection);
+}
+
+void VideoEncoder::queTaskNow() {
+    TaskScheduler::instance()->queEncodeTask(ref<eTask>());
+}
+
+void VideoEncoder::inputAdded() {
+    if(isActive()) mInputAdded = true;
+    else queTask();
 }
 
 void VideoEncoder::addContainer(const stdsptr<SceneFrameContainer>& cont) {
     if(!cont) return;
-    mNextContainers.append(cont);
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    if(mImageSequence) {
+        writeSequenceFrames(cont);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mQueueMutex);
+        mQueue.append(cont);
+    }
+    inputAdded();
 }
 
 void VideoEncoder::addContainer(const stdsptr<Samples>& cont) {
     if(!cont) return;
     mNextSoundConts.append(cont);
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    inputAdded();
 }
 
 void VideoEncoder::allAudioProvided() {
     mAllAudioProvided = true;
-    if(getState() < eTaskState::qued || getState() > eTaskState::processing) queTask();
+    inputAdded();
+}
+
+bool VideoEncoder::queueFull() const {
+    if(mImageSequence)
+        return mPendingWrites >= qMax(4, 2*QThread::idealThreadCount());
+    const int inFlight = eSettings::sInstance->fOutputFramesInFlight;
+    const int capacity = qMax(4, 2*inFlight);
+    std::lock_guard<std::mutex> lk(mQueueMutex);
+    return mQueue.count() >= capacity;
+}
+
+bool VideoEncoder::nextContainer() {
+    if(_mCurrentContainer) return true;
+    std::lock_guard<std::mutex> lk(mQueueMutex);
+    if(mQueue.isEmpty()) return false;
+    _mCurrentContainer = mQueue.takeFirst();
+    return true;
+}
+
+void VideoEncoder::containerEncoded() {
+    {
+        std::lock_guard<std::mutex> lk(mQueueMutex);
+        mEncoded << _mCurrentContainer;
+    }
+    _mCurrentContainer.reset();
+    emit mEmitter.framesEncoded();
+}
+
+void VideoEncoder::updateEncodedFrame() {
+    QList<stdsptr<SceneFrameContainer>> encoded;
+    {
+        std::lock_guard<std::mutex> lk(mQueueMutex);
+        encoded.swap(mEncoded);
+    }
+    if(encoded.isEmpty() || !mCurrentlyEncoding) return;
+    const auto& lastEncoded = encoded.last();
+    const auto currCanvas = mRenderInstanceSettings->getTargetCanvas();
+    if(!mEncodingFinished) currCanvas->setSceneFrame(lastEncoded);
+    currCanvas->setMinFrameUseRange(lastEncoded->getRange().fMax + 1);
 }
 
 static AVFrame *allocPicture(enum AVPixelFormat pix_fmt,
@@ -79,6 +145,9 @@ static void openVideo(const AVCodec * const codec, OutputStream * const ost) {
     int ret = avcodec_open2(c, codec, nullptr);
     if(ret < 0) AV_RuntimeThrow(ret, "Could not open codec")
 
+    const auto desc = avcodec_descriptor_get(c->codec_id);
+    ost->fIntraOnly = desc && (desc->props & AV_CODEC_PROP_INTRA_ONLY);
+
     /* Allocate the encoded raw picture. */
     ost->fDstFrame = allocPicture(c->pix_fmt, c->width, c->height);
     if(!ost->fDstFrame) RuntimeThrow("Could not allocate picture");
@@ -113,6 +182,10 @@ static void addVideoStream(OutputStream * const ost,
 
     /* Put sample parameters. */
     c->bit_rate = outSettings.fVideoBitrate;//settings->getVideoBitrate();
+    /* Frames are fed continuously and only flushed at the end,
+     * so frame threaded encoders can keep their lookahead. */
+    c->thread_count = qMax(0, outSettings.fVideoThreads);
+    c->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
     /* Resolution must be a multiple of two. */
     c->width    = renSettings.fVideoWidth;
     c->height   = renSettings.fVideoHeight;
@@ -140,9 +213,153 @@ static void addVideoStream(OutputStream * const ost,
     }
 }
 
+// more than the vertical taps of SWS_BICUBIC for 2:1 chroma
+static const int sSliceOverlap = 16;
+
+static void initSwsSlices(OutputStream * const ost) {
+    const AVCodecContext * const c = ost->fCodec;
+    const auto desc = av_pix_fmt_desc_get(c->pix_fmt);
+    if(!desc) RuntimeThrow("Unknown output pixel format");
+    const bool sliceable = !(desc->flags & (AV_PIX_FMT_FLAG_PAL |
+                                            AV_PIX_FMT_FLAG_BITSTREAM |
+                                            AV_PIX_FMT_FLAG_HWACCEL));
+    // at least 64 lines per slice, slices aligned to chroma rows
+    const int maxSlices = sliceable ? qMax(1, c->height/64) : 1;
+    const int nThreads = eSettings::sCpuThreadsCapped();
+    const int nSlices = qBound(1, nThreads, maxSlices);
+    const int align = 1 << desc->log2_chroma_h;
+    int sliceHeight = (c->height + nSlices - 1)/nSlices;
+    sliceHeight = (sliceHeight + align - 1)/align*align;
+    for(int y = 0; y < c->height; y += sliceHeight) {
+        ost->fSwsSlices.emplace_back();
+        auto& slice = ost->fSwsSlices.back();
+        slice.fY = y;
+        slice.fHeight = qMin(sliceHeight, c->height - y);
+        if(nSlices > 1) {
+            slice.fTop = qMin(sSliceOverlap, y);
+            slice.fBottom = qMin(sSliceOverlap,
+                                 c->height - y - slice.fHeight);
+        }
+        const int h = slice.fTop + slice.fHeight + slice.fBottom;
+        slice.fContext = sws_getContext(c->width, h, AV_PIX_FMT_RGBA,
+                                        c->width, h, c->pix_fmt,
+                                        SWS_BICUBIC, nullptr, nullptr, nullptr);
+        if(!slice.fContext) RuntimeThrow("Cannot initialize the conversion context");
+        if(nSlices == 1) continue;
+        slice.fFrame = av_frame_alloc();
+        if(!slice.fFrame) RuntimeThrow("Could not allocate slice frame");
+        slice.fFrame->format = c->pix_fmt;
+        slice.fFrame->width = c->width;
+        slice.fFrame->height = h;
+        const int ret = av_frame_get_buffer(slice.fFrame, 0);
+        if(ret < 0) AV_RuntimeThrow(ret, "Could not allocate slice frame")
+    }
+}
+
+static void freeSwsSlices(OutputStream * const ost) {
+    for(auto& slice : ost->fSwsSlices) {
+        sws_freeContext(slice.fContext);
+        if(slice.fFrame) av_frame_free(&slice.fFrame);
+    }
+    ost->fSwsSlices.clear();
+}
+
+static void convertSlice(const OutputStream * const ost,
+                         const SwsSlice& slice,
+                         const uint8_t * const src,
+                         const int srcLinesize) {
+    const AVCodecContext * const c = ost->fCodec;
+    AVFrame * const frame = ost->fDstFrame;
+    const auto desc = av_pix_fmt_desc_get(c->pix_fmt);
+    const int srcY = slice.fY - slice.fTop;
+    const int h = slice.fTop + slice.fHeight + slice.fBottom;
+    const uint8_t * const srcSlice[] = {src + srcY*srcLinesize};
+    const int srcLinesizes[] = {srcLinesize};
+    if(!slice.fFrame) {
+        uint8_t* dstSlice[4];
+        for(int p = 0; p < 4; p++) {
+            if(!frame->data[p]) {
+                dstSlice[p] = nullptr;
+                continue;
+            }
+            const int shift = (p == 1 || p == 2) ? desc->log2_chroma_h : 0;
+            dstSlice[p] = frame->data[p] + (srcY >> shift)*frame->linesize[p];
+        }
+        sws_scale(slice.fContext, srcSlice, srcLinesizes, 0, h,
+                  dstSlice, frame->linesize);
+        return;
+    }
+    const auto tmp = slice.fFrame;
+    sws_scale(slice.fContext, srcSlice, srcLinesizes, 0, h,
+              tmp->data, tmp->linesize);
+    // only the rows of the slice itself go to the output frame
+    const int nPlanes = av_pix_fmt_count_planes(c->pix_fmt);
+    for(int p = 0; p < nPlanes; p++) {
+        const int shift = (p == 1 || p == 2) ? desc->log2_chroma_h : 0;
+        const int top = slice.fTop >> shift;
+        const int y = slice.fY >> shift;
+        const int end = (slice.fY + slice.fHeight + (1 << shift) - 1) >> shift;
+        const int rows = end - y;
+        const int bytes = av_image_get_linesize(c->pix_fmt, c->width, p);
+        av_image_copy_plane(frame->data[p] + y*frame->linesize[p],
+                            frame->linesize[p],
+                            tmp->data[p] + top*tmp->linesize[p],
+                            tmp->linesize[p], bytes, rows);
+    }
+}
+
+static void convertToDstFrame(OutputStream * const ost,
+                              const uint8_t * const src,
+                              const int srcLinesize) {
+    const int nSlices = int(ost->fSwsSlices.size());
+    if(nSlices == 1) return convertSlice(ost, ost->fSwsSlices.front(),
+                                         src, srcLinesize);
+    // the other slices go to the cpu executors, this thread does the first
+    std::mutex mutex;
+    std::condition_variable done;
+    int remaining = nSlices - 1;
+    bool failed = false;
+    const auto finishSlice = [&](const bool success) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!success) failed = true;
+        if(--remaining == 0) done.notify_one();
+    };
+    for(int i = 1; i < nSlices; i++) {
+        const auto run = [&, i]() {
+            const auto& slice = ost->fSwsSlices[static_cast<size_t>(i)];
+            // has to report back, the encoder thread is waiting
+            try {
+                convertSlice(ost, slice, src, srcLinesize);
+            } catch(...) {
+                return finishSlice(false);
+            }
+            finishSlice(true);
+        };
+        const auto canceled = [&]() { finishSlice(false); };
+        CpuTaskExecutor::sAddTask(enve::make_shared<eCustomCpuTask>(
+                                      nullptr, run, nullptr, canceled));
+    }
+    bool firstFailed = false;
+    try {
+        convertSlice(ost, ost->fSwsSlices.front(), src, srcLinesize);
+    } catch(...) {
+        firstFailed = true;
+    }
+    // the tasks reference this stack frame, wait for all of them
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&remaining]() { return remaining == 0; });
+    if(failed || firstFailed) RuntimeThrow("Frame conversion failed");
+}
+
 static AVFrame *getVideoFrame(OutputStream * const ost,
-                              const sk_sp<SkImage> &image) {
+                              const sk_sp<SkImage> &image,
+                              const bool reuse) {
     AVCodecContext *c = ost->fCodec;
+    // the previous frame is identical, skip the conversion
+    if(reuse) {
+        ost->fDstFrame->pts = ost->fNextPts++;
+        return ost->fDstFrame;
+    }
 
     /* check if we want to generate more frames */
 //    if(av_compare_ts(ost->next_pts, c->time_base,
@@ -151,42 +368,67 @@ static AVFrame *getVideoFrame(OutputStream * const ost,
 
     /* as we only generate a rgba picture, we must convert it
      * to the codec pixel format if needed */
-    if(!ost->fSwsCtx) {
-        ost->fSwsCtx = sws_getContext(c->width, c->height,
-                                      AV_PIX_FMT_RGBA,
-                                      c->width, c->height,
-                                      c->pix_fmt, SWS_BICUBIC,
-                                      nullptr, nullptr, nullptr);
-        if(!ost->fSwsCtx)
-            RuntimeThrow("Cannot initialize the conversion context");
-    }
+    if(ost->fSwsSlices.empty()) initSwsSlices(ost);
     SkPixmap pixmap;
     image->peekPixels(&pixmap);
-    const uint8_t * const dstSk[] = {static_cast<uint8_t*>(pixmap.writable_addr())};
+    const auto srcSk = static_cast<const uint8_t*>(pixmap.addr());
     int linesizesSk[4];
 
     av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, image->width());
     const int ret = av_frame_make_writable(ost->fDstFrame) ;
     if(ret < 0) AV_RuntimeThrow(ret, "Could not make AVFrame writable")
 
-    sws_scale(ost->fSwsCtx, dstSk,
-              linesizesSk, 0, c->height, ost->fDstFrame->data,
-              ost->fDstFrame->linesize);
+    QElapsedTimer timer;
+    timer.start();
+    convertToDstFrame(ost, srcSk, linesizesSk[0]);
+    ost->fConvertTimeUs += timer.nsecsElapsed()/1000;
 
     ost->fDstFrame->pts = ost->fNextPts++;
 
     return ost->fDstFrame;
 }
 
+static int writePacket(AVFormatContext * const oc,
+                       OutputStream * const ost,
+                       AVPacket * const pkt) {
+    int nDuplicates = 0;
+    const auto dup = ost->fDuplicates.find(pkt->pts);
+    if(dup != ost->fDuplicates.end()) {
+        nDuplicates = dup->second;
+        ost->fDuplicates.erase(dup);
+    }
+    AVPacket * src = nDuplicates > 0 ? av_packet_clone(pkt) : nullptr;
+
+    av_packet_rescale_ts(pkt, ost->fCodec->time_base, ost->fStream->time_base);
+    pkt->stream_index = ost->fStream->index;
+    int ret = av_interleaved_write_frame(oc, pkt);
+
+    for(int i = 1; i <= nDuplicates && ret >= 0; i++) {
+        AVPacket copy;
+        av_init_packet(&copy);
+        ret = av_packet_ref(&copy, src);
+        if(ret < 0) break;
+        copy.pts = src->pts + i;
+        copy.dts = src->dts + i;
+        av_packet_rescale_ts(&copy, ost->fCodec->time_base,
+                             ost->fStream->time_base);
+        copy.stream_index = ost->fStream->index;
+        ret = av_interleaved_write_frame(oc, &copy);
+    }
+    if(src) av_packet_free(&src);
+    return ret;
+}
+
 static void writeVideoFrame(AVFormatContext * const oc,
                             OutputStream * const ost,
                             const sk_sp<SkImage> &image,
+                            const bool reuse,
                             bool * const encodeVideo) {
     AVCodecContext * const c = ost->fCodec;
 
     AVFrame * frame;
     try {
-        frame = getVideoFrame(ost, image);
+        frame = getVideoFrame(ost, image, reuse);
     } catch(...) {
         RuntimeThrow("Failed to retrieve video frame");
     }
@@ -202,11 +444,8 @@ static void writeVideoFrame(AVFormatContext * const oc,
 
         const int recRet = avcodec_receive_packet(c, &pkt);
         if(recRet >= 0) {
-            av_packet_rescale_ts(&pkt, c->time_base, ost->fStream->time_base);
-            pkt.stream_index = ost->fStream->index;
-
             // Write the compressed frame to the media file.
-            const int interRet = av_interleaved_write_frame(oc, &pkt);
+            const int interRet = writePacket(oc, ost, &pkt);
             if(interRet < 0) AV_RuntimeThrow(interRet, "Error while writing video frame")
         } else if(recRet == AVERROR(EAGAIN) || recRet == AVERROR_EOF) {
             *encodeVideo = ret != AVERROR_EOF;
@@ -479,6 +718,84 @@ void VideoEncoder::startEncodingNow() {
                                   "Could not write header to " + mPathByteArray.data())
 }
 
+void VideoEncoder::startImageSequenceNow() {
+    const QFileInfo info(mRenderInstanceSettings->getOutputDestination());
+    if(!info.dir().mkpath("."))
+        RuntimeThrow("Could not create " + info.absolutePath());
+    mEncodeVideo = false;
+    mEncodeAudio = false;
+    mAllAudioProvided = true;
+}
+
+void VideoEncoder::writeSequenceFrames(const stdsptr<SceneFrameContainer> &cont) {
+    using Format = ImageSequenceFrameWriter::Format;
+    Format format;
+    switch(mOutputSettings.fVideoCodec->id) {
+    case AV_CODEC_ID_TIFF: format = Format::tiff; break;
+    case AV_CODEC_ID_MJPEG: format = Format::jpeg; break;
+    default: format = Format::png;
+    }
+    const auto pixDesc = av_pix_fmt_desc_get(mOutputSettings.fVideoPixelFormat);
+    const bool sixteenBit = pixDesc && pixDesc->comp[0].depth > 8;
+    const bool alpha = !pixDesc || (pixDesc->flags & AV_PIX_FMT_FLAG_ALPHA);
+
+    const QString dst = mRenderInstanceSettings->getOutputDestination();
+    const QFileInfo dstInfo(dst);
+    const int sequenceId = mSequenceId;
+    const auto image = cont->getImage();
+    const FrameRange renderRange{mRenderSettings.fMinFrame,
+                                 mRenderSettings.fMaxFrame};
+    const auto range = cont->getRange()*renderRange;
+    QStringList framePaths;
+    for(int frame = range.fMin; frame <= range.fMax; frame++) {
+        char path[4096];
+        QString framePath;
+        if(av_get_frame_filename(path, sizeof(path),
+                                 mPathByteArray.constData(), frame) >= 0) {
+            framePath = QString::fromUtf8(path);
+        } else {
+            framePath = dstInfo.path() + "/" + dstInfo.completeBaseName() +
+                        QString("_%1.").arg(frame, 5, 10, QChar('0')) +
+                        dstInfo.suffix();
+        }
+        framePaths << framePath;
+    }
+    const int nFrames = framePaths.count();
+    if(nFrames > 0) {
+        // the render handler may start the next render on finish,
+        // not from inside the task callback
+        const auto done = [this, sequenceId, nFrames](const QString& error) {
+            QMetaObject::invokeMethod(&mEmitter, [this, sequenceId,
+                                                  nFrames, error]() {
+                sequenceFrameWritten(sequenceId, nFrames, error);
+            }, Qt::QueuedConnection);
+        };
+        const auto task = enve::make_shared<ImageSequenceFrameWriter>(
+                    image, framePaths, format, sixteenBit, alpha, done);
+        mPendingWrites++;
+        task->queTask();
+    }
+    const auto currCanvas = mRenderInstanceSettings->getTargetCanvas();
+    currCanvas->setSceneFrame(cont);
+    currCanvas->setMinFrameUseRange(range.fMax + 1);
+}
+
+void VideoEncoder::sequenceFrameWritten(const int sequenceId,
+                                        const int nFrames,
+                                        const QString& error) {
+    if(sequenceId != mSequenceId) return;
+    mPendingWrites--;
+    if(!error.isEmpty()) {
+        mRenderInstanceSettings->setCurrentState(RenderState::error, error);
+        finishEncodingNow();
+        mEmitter.encodingFailed();
+        return;
+    }
+    mEncodedFrames += nFrames;
+    emit mEmitter.framesEncoded();
+    if(mPendingWrites == 0 && mEncodingFinished) finishEncodingSuccess();
+}
+
 bool VideoEncoder::startEncoding(RenderInstanceSettings * const settings) {
     if(mCurrentlyEncoding) return false;
     mRenderInstanceSettings = settings;
@@ -489,8 +806,14 @@ bool VideoEncoder::startEncoding(RenderInstanceSettings * const settings) {
 
     mOutputFormat = mOutputSettings.fOutputFormat;
     mSoundIterator = SoundIterator();
+    mEncodeTimeUs = 0;
+    mConvertTimeUs = 0;
+    mEncodedFrames = 0;
+    mImageSequence = mOutputSettings.isImageSequence();
+    mPendingWrites = 0;
     try {
-        startEncodingNow();
+        if(mImageSequence) startImageSequenceNow();
+        else startEncodingNow();
         mCurrentlyEncoding = true;
         mEncodingFinished = false;
         mRenderInstanceSettings->setCurrentState(RenderState::rendering);
@@ -512,9 +835,9 @@ void VideoEncoder::interrupEncoding() {
 }
 
 void VideoEncoder::finishEncodingSuccess() {
-    mRenderInstanceSettings->setCurrentState(RenderState::finished);
     mEncodingSuccesfull = true;
     finishEncodingNow();
+    mRenderInstanceSettings->setCurrentState(RenderState::finished);
     mEmitter.encodingFinished();
 }
 
@@ -532,17 +855,7 @@ static void flushStream(OutputStream * const ost,
             avcodec_flush_buffers(ost->fCodec);
             break;
         }
-        if(pkt.pts != AV_NOPTS_VALUE)
-            pkt.pts = av_rescale_q(pkt.pts, ost->fCodec->time_base,
-                                   ost->fStream->time_base);
-        if(pkt.dts != AV_NOPTS_VALUE)
-            pkt.dts = av_rescale_q(pkt.dts, ost->fCodec->time_base,
-                                   ost->fStream->time_base);
-        if(pkt.duration > 0)
-            pkt.duration = av_rescale_q(pkt.duration, ost->fCodec->time_base,
-                                        ost->fStream->time_base);
-        pkt.stream_index = ost->fStream->index;
-        ret = av_interleaved_write_frame(formatCtx, &pkt);
+        ret = writePacket(formatCtx, ost, &pkt);
     }
 }
 
@@ -554,7 +867,7 @@ static void closeStream(OutputStream * const ost) {
     }
     if(ost->fDstFrame) av_frame_free(&ost->fDstFrame);
     if(ost->fSrcFrame) av_frame_free(&ost->fSrcFrame);
-    if(ost->fSwsCtx) sws_freeContext(ost->fSwsCtx);
+    freeSwsSlices(ost);
     if(ost->fSwrCtx) swr_free(&ost->fSwrCtx);
     *ost = OutputStream();
 }
@@ -562,32 +875,35 @@ static void closeStream(OutputStream * const ost) {
 void VideoEncoder::finishEncodingNow() {
     if(!mCurrentlyEncoding) return;
 
-    if(mEncodeVideo) flushStream(&mVideoStream, mFormatContext);
+    if(mEncodeVideo) {
+        mConvertTimeUs = mVideoStream.fConvertTimeUs;
+        QElapsedTimer timer;
+        timer.start();
+        flushStream(&mVideoStream, mFormatContext);
+        mEncodeTimeUs += timer.nsecsElapsed()/1000;
+    }
     if(mEncodeAudio) flushStream(&mAudioStream, mFormatContext);
 
-    if(mEncodingSuccesfull) av_write_trailer(mFormatContext);
+    if(mEncodingSuccesfull && mFormatContext) av_write_trailer(mFormatContext);
 
     /* Close each codec. */
     if(mEncodeVideo) closeStream(&mVideoStream);
     if(mEncodeAudio) closeStream(&mAudioStream);
 
-    if(mOutputFormat) {
-        if(!(mOutputFormat->flags & AVFMT_NOFILE)) {
+    if(mFormatContext) {
+        if(!mOutputFormat || !(mOutputFormat->flags & AVFMT_NOFILE)) {
             avio_close(mFormatContext->pb);
         }
-    } else if(mFormatContext) {
-        avio_close(mFormatContext->pb);
-    }
-    if(mFormatContext) {
         avformat_free_context(mFormatContext);
         mFormatContext = nullptr;
     }
+    mSequenceId++;
+    mPendingWrites = 0;
 
     mEncodeAudio = false;
     mEncodeVideo = false;
     mCurrentlyEncoding = false;
     mEncodingSuccesfull = false;
-    mNextContainers.clear();
     mNextSoundConts.clear();
     clearContainers();
 
@@ -595,12 +911,18 @@ void VideoEncoder::finishEncodingNow() {
 }
 
 void VideoEncoder::clearContainers() {
-    _mContainers.clear();
+    {
+        std::lock_guard<std::mutex> lk(mQueueMutex);
+        mQueue.clear();
+        mEncoded.clear();
+    }
+    _mCurrentContainer.reset();
+    _mCurrentContainerFrame = 0;
     mSoundIterator.clear();
 }
 
 void VideoEncoder::process() {
-    bool hasVideo = !_mContainers.isEmpty(); // local encode
+    bool hasVideo = nextContainer();
     bool hasAudio;
     if(mEncodeAudio) {
         if(_mAllAudioProvided) {
@@ -610,6 +932,7 @@ void VideoEncoder::process() {
         }
     } else hasAudio = false;
     while((mEncodeVideo && hasVideo) || (mEncodeAudio && hasAudio)) {
+        if(mInterruptEncoding) break;
         bool videoAligned = true;
         if(mEncodeVideo && mEncodeAudio) {
             videoAligned = av_compare_ts(mVideoStream.fNextPts,
@@ -619,20 +942,38 @@ void VideoEncoder::process() {
         }
         const bool encodeVideo = mEncodeVideo && hasVideo && videoAligned;
         if(encodeVideo) {
-            const auto cacheCont = _mContainers.at(_mCurrentContainerId);
+            const auto& cacheCont = _mCurrentContainer;
             const auto contRange = cacheCont->getRange()*_mRenderRange;
             const int nFrames = contRange.span();
+            // remaining frames of the container are identical
+            const bool reuse = _mCurrentContainerFrame > 0;
+            const bool duplicate = !reuse && nFrames > 1 &&
+                                   mVideoStream.fIntraOnly;
+            if(duplicate) {
+                const int64_t pts = mVideoStream.fNextPts;
+                mVideoStream.fDuplicates[pts] = nFrames - 1;
+            }
             try {
+                QElapsedTimer timer;
+                timer.start();
                 writeVideoFrame(mFormatContext, &mVideoStream,
-                                cacheCont->getImage(), &hasVideo);
-                avcodec_flush_buffers(mVideoStream.fCodec);
+                                cacheCont->getImage(), reuse, &hasVideo);
+                mEncodeTimeUs += timer.nsecsElapsed()/1000;
             } catch(...) {
                 RuntimeThrow("Failed to write video frame");
             }
-            if(++_mCurrentContainerFrame >= nFrames) {
-                _mCurrentContainerId++;
+            if(duplicate) {
+                mVideoStream.fNextPts += nFrames - 1;
+                mEncodedFrames += nFrames;
+                _mCurrentContainerFrame = nFrames;
+            } else {
+                mEncodedFrames++;
+                _mCurrentContainerFrame++;
+            }
+            if(_mCurrentContainerFrame >= nFrames) {
                 _mCurrentContainerFrame = 0;
-                hasVideo = _mCurrentContainerId < _mContainers.count();
+                containerEncoded();
+                hasVideo = nextContainer();
             }
         }
         bool audioAligned = true;
@@ -647,7 +988,6 @@ void VideoEncoder::process() {
             try {
                 processAudioStream(mFormatContext, &mAudioStream,
                                    mSoundIterator, &hasAudio);
-                avcodec_flush_buffers(mAudioStream.fCodec);
             } catch(...) {
                 RuntimeThrow("Failed to process audio stream");
             }
@@ -660,15 +1000,8 @@ void VideoEncoder::process() {
 
 
 void VideoEncoder::beforeProcessing(const Hardware) {
-    _mCurrentContainerId = 0;
+    mInputAdded = false;
     _mAllAudioProvided = mAllAudioProvided;
-    if(_mContainers.isEmpty()) {
-        _mContainers.swap(mNextContainers);
-    } else {
-        for(const auto& cont : mNextContainers)
-            _mContainers.append(cont);
-        mNextContainers.clear();
-    }
     for(const auto& sound : mNextSoundConts)
         mSoundIterator.add(sound);
     mNextSoundConts.clear();
@@ -677,18 +1010,7 @@ void VideoEncoder::beforeProcessing(const Hardware) {
 }
 
 void VideoEncoder::afterProcessing() {
-    const auto currCanvas = mRenderInstanceSettings->getTargetCanvas();
-    if(_mCurrentContainerId != 0) {
-        const auto lastEncoded = _mContainers.at(_mCurrentContainerId - 1);
-        currCanvas->setSceneFrame(lastEncoded);
-        currCanvas->setMinFrameUseRange(lastEncoded->getRange().fMax + 1);
-    }
-
-    for(int i = _mContainers.count() - 1; i >= _mCurrentContainerId; i--) {
-        const auto &cont = _mContainers.at(i);
-        mNextContainers.prepend(cont);
-    }
-    _mContainers.clear();
+    updateEncodedFrame();
 
     if(mInterruptEncoding) {
         interrupEncoding();
@@ -698,8 +1020,8 @@ void VideoEncoder::afterProcessing() {
         mRenderInstanceSettings->setCurrentState(RenderState::error, "Error");
         finishEncodingNow();
         mEmitter.encodingFailed();
-    } else if(mEncodingFinished) finishEncodingSuccess();
-    else if(!mNextContainers.isEmpty()) queTask();
+    } else if(mInputAdded) queTask();
+    else if(mEncodingFinished) finishEncodingSuccess();
 }
 
 void VideoEncoder::sFinishEncoding() {
@@ -714,6 +1036,10 @@ bool VideoEncoder::sEncodeAudio() {
     return sInstance->mEncodeAudio;
 }
 
+bool VideoEncoder::sQueueFull() {
+    return sInstance->queueFull();
+}
+
 void VideoEncoder::sInterruptEncoding() {
     sInstance->interruptCurrentEncoding();
 }
@@ -18,6 +18,10 @@
 #define VIDEOENCODER_H
 #include <QString>
 #include <QList>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
 #include "skia/skiaincludes.h"
 #include "Tasks/updatable.h"
 #include "renderinstancesettings.h"
@@ -144,6 +148,18 @@ private:
     QList<stdsptr<Samples>> mSamples;
 };
 
+//! @brief Horizontal band of the frame with its own conversion context.
+//! Rows of overlap above and below are converted into fFrame too,
+//! so that the vertical filter taps see the same input as in one pass.
+struct SwsSlice {
+    struct SwsContext* fContext = nullptr;
+    AVFrame* fFrame = nullptr;
+    int fY = 0;
+    int fHeight = 0;
+    int fTop = 0;
+    int fBottom = 0;
+};
+
 typedef struct OutputStream {
     // pts of the next frame that will be generated
     int64_t fNextPts;
@@ -152,7 +168,12 @@ typedef struct OutputStream {
     AVCodecContext *fCodec = nullptr;
     AVFrame *fDstFrame = nullptr;
     AVFrame *fSrcFrame = nullptr;
-    struct SwsContext *fSwsCtx = nullptr;
+    std::vector<SwsSlice> fSwsSlices;
+    int64_t fConvertTimeUs = 0;
+    // intra only codecs repeat packets instead of encoding identical frames
+    bool fIntraOnly = false;
+    // number of copies to write after the packet with the given pts
+    std::map<int64_t, int> fDuplicates;
     struct SwrContext *fSwrCtx = nullptr;
 } OutputStream;
 
@@ -167,6 +188,9 @@ signals:
 
     void encodingStartFailed();
     void encodingFailed();
+
+    //! @brief Emitted from the encoder thread after each encoded container.
+    void framesEncoded();
 };
 
 class VideoEncoder : public eHddTask {
@@ -189,7 +213,7 @@ public:
 
     void finishCurrentEncoding() {
         if(!mCurrentlyEncoding) return;
-        if(isActive()) mEncodingFinished = true;
+        if(isActive() || mPendingWrites > 0) mEncodingFinished = true;
         else finishEncodingSuccess();
     }
 
@@ -197,6 +221,8 @@ public:
     void addContainer(const stdsptr<Samples> &cont);
     void allAudioProvided();
 
+    bool queueFull() const;
+
     static VideoEncoder *sInstance;
 
     static void sInterruptEncoding();
@@ -207,6 +233,7 @@ public:
     static void sFinishEncoding();
     static bool sEncodingSuccessfulyStarted();
     static bool sEncodeAudio();
+    static bool sQueueFull();
 
     VideoEncoderEmitter *getEmitter() {
         return &mEmitter;
@@ -215,18 +242,34 @@ public:
     bool getCurrentlyEncoding() const {
         return mCurrentlyEncoding;
     }
+
+    //! @brief Time spent encoding video frames in the last encoding.
+    qint64 encodeTimeUs() const { return mEncodeTimeUs; }
+    int encodedFrames() const { return mEncodedFrames; }
+    //! @brief Part of encodeTimeUs spent converting RGBA to fVideoPixelFormat.
+    qint64 convertTimeUs() const { return mConvertTimeUs; }
 protected:
+    void queTaskNow();
+
     void clearContainers();
+    void inputAdded();
+    bool nextContainer();
+    void containerEncoded();
+    void updateEncodedFrame();
     VideoEncoderEmitter mEmitter;
     void interrupEncoding();
     void finishEncodingSuccess();
     void finishEncodingNow();
     bool startEncoding(RenderInstanceSettings * const settings);
     void startEncodingNow();
+    void startImageSequenceNow();
+    void writeSequenceFrames(const stdsptr<SceneFrameContainer> &cont);
+    void sequenceFrameWritten(const int sequenceId, const int nFrames,
+                              const QString& error);
 
     bool mEncodingSuccesfull = false;
     bool mEncodingFinished = false;
-    bool mInterruptEncoding = false;
+    std::atomic<bool> mInterruptEncoding{false};
 
     eSoundSettingsData mInSoundSettings;
     OutputStream mVideoStream;
@@ -234,8 +277,19 @@ protected:
     AVFormatContext *mFormatContext = nullptr;
     const AVOutputFormat *mOutputFormat = nullptr;
     bool mCurrentlyEncoding = false;
-    QList<stdsptr<SceneFrameContainer>> mNextContainers;
     QList<stdsptr<Samples>> mNextSoundConts;
+    bool mInputAdded = false;
+
+    bool mImageSequence = false;
+    int mSequenceId = 0;
+    //! @brief Image sequence frames still being written
+    int mPendingWrites = 0;
+
+    //! @brief Frames waiting for the encoder thread, bounded by queueFull()
+    QList<stdsptr<SceneFrameContainer>> mQueue;
+    //! @brief Encoded frames, released on the main thread
+    QList<stdsptr<SceneFrameContainer>> mEncoded;
+    mutable std::mutex mQueueMutex;
 
     RenderSettings mRenderSettings;
     OutputSettings mOutputSettings;
@@ -245,12 +299,16 @@ protected:
     bool mEncodeAudio = false;
     bool mAllAudioProvided = false;
 
+    // written on the encoder thread, read from the gui
+    std::atomic<qint64> mEncodeTimeUs{0};
+    std::atomic<qint64> mConvertTimeUs{0};
+    std::atomic<int> mEncodedFrames{0};
+
     bool _mAllAudioProvided = false;
-    int _mCurrentContainerId = 0;
     int _mCurrentContainerFrame = 0; // some containers will add multiple frames
     FrameRange _mRenderRange;
 
-    QList<stdsptr<SceneFrameContainer>> _mContainers;
+    stdsptr<SceneFrameContainer> _mCurrentContainer;
     SoundIterator mSoundIterator;
 };
 
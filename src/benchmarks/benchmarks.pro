@@ -0,0 +1,49 @@
+# enve - 2D animations software
+# Copyright (C) 2016-2020 Maurycy Liebner
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Command-line micro-benchmarks, run enve-benchmarks --help for the list
+
+QT += core gui
+LIBS += -lavutil -lavformat -lavcodec -lswscale -lswresample
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES += QT_NO_FOREACH
+
+# Include third-party dependencies from core
+include(../core/core.pri)
+
+ENVE_CORE_FOLDER = ../core
+
+INCLUDEPATH += $$ENVE_CORE_FOLDER
+DEPENDPATH += $$ENVE_CORE_FOLDER
+LIBS += -L$$OUT_PWD/../core -lenvecore
+
+win32 { # Windows
+    CONFIG -= debug_and_release
+}
+
+TARGET = enve-benchmarks
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    encodebenchmark.cpp \
+    mixbenchmark.cpp \
+    pixelkernelsbenchmark.cpp
+
+HEADERS += \
+    encodebenchmark.h \
+    mixbenchmark.h \
+    pixelkernelsbenchmark.h
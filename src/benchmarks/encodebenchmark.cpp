@@ -0,0 +1,157 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "encodebenchmark.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+
+#include "exceptions.h"
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavutil/imgutils.h>
+}
+
+struct EncodeParams {
+    const AVCodec* fCodec;
+    int fWidth;
+    int fHeight;
+    int fFrames;
+    int fBitrate;
+};
+
+// moving gradients, so that motion estimation has something to do
+static void fillFrame(AVFrame * const frame, const int id) {
+    for(int y = 0; y < frame->height; y++) {
+        uint8_t * const row = frame->data[0] + y*frame->linesize[0];
+        for(int x = 0; x < frame->width; x++) {
+            row[x] = static_cast<uint8_t>(x + y + 3*id);
+        }
+    }
+    for(int p = 1; p < 3; p++) {
+        for(int y = 0; y < frame->height/2; y++) {
+            uint8_t * const row = frame->data[p] + y*frame->linesize[p];
+            for(int x = 0; x < frame->width/2; x++) {
+                row[x] = static_cast<uint8_t>(128 + p*(x - y) + id);
+            }
+        }
+    }
+}
+
+static void drainPackets(AVCodecContext * const c, AVPacket * const pkt) {
+    while(true) {
+        const int ret = avcodec_receive_packet(c, pkt);
+        if(ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) return;
+        if(ret < 0) RuntimeThrow("Error encoding a frame");
+        av_packet_unref(pkt);
+    }
+}
+
+//! @brief Returns encoded frames per second, frame generation excluded.
+static qreal encodeFps(const EncodeParams& params,
+                       const bool continuous, const int threads) {
+    auto c = avcodec_alloc_context3(params.fCodec);
+    if(!c) RuntimeThrow("Could not alloc an encoding context");
+    c->width = params.fWidth;
+    c->height = params.fHeight;
+    c->bit_rate = params.fBitrate;
+    c->time_base = {1, 25};
+    c->framerate = {25, 1};
+    c->gop_size = 12;
+    c->pix_fmt = AV_PIX_FMT_YUV420P;
+    if(continuous) {
+        c->thread_count = threads;
+        c->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    }
+    auto frame = av_frame_alloc();
+    auto pkt = av_packet_alloc();
+    const auto freeAll = [&c, &frame, &pkt]() {
+        av_packet_free(&pkt);
+        av_frame_free(&frame);
+        avcodec_free_context(&c);
+    };
+    qint64 encodeNs = 0;
+    try {
+        if(avcodec_open2(c, params.fCodec, nullptr) < 0)
+            RuntimeThrow("Could not open codec " + params.fCodec->name);
+        frame->format = c->pix_fmt;
+        frame->width = c->width;
+        frame->height = c->height;
+        if(av_frame_get_buffer(frame, 0) < 0)
+            RuntimeThrow("Could not allocate frame data");
+        QElapsedTimer timer;
+        for(int i = 0; i < params.fFrames; i++) {
+            if(av_frame_make_writable(frame) < 0)
+                RuntimeThrow("Could not make frame writable");
+            fillFrame(frame, i);
+            frame->pts = i;
+            timer.start();
+            if(avcodec_send_frame(c, frame) < 0)
+                RuntimeThrow("Error sending a frame for encoding");
+            drainPackets(c, pkt);
+            if(!continuous) avcodec_flush_buffers(c);
+            encodeNs += timer.nsecsElapsed();
+        }
+        timer.start();
+        avcodec_send_frame(c, nullptr);
+        drainPackets(c, pkt);
+        encodeNs += timer.nsecsElapsed();
+    } catch(...) {
+        freeAll();
+        throw;
+    }
+    freeAll();
+    return encodeNs > 0 ? params.fFrames*1e9/encodeNs : 0;
+}
+
+int encodeBenchmark(const QStringList& args) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares encoding fps before and "
+                                     "after removing per-frame flushes");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"codec", "Encoder name.", "name", "libx264"},
+        {"size", "Frame size.", "WxH", "1920x1080"},
+        {"frames", "Number of frames to encode.", "n", "120"},
+        {"bitrate", "Bitrate in Mbps.", "mbps", "20"},
+        {"video-threads", "Encoder threads, 0 for automatic.", "n", "0"}
+    });
+    parser.process(args);
+
+    EncodeParams params;
+    const QString codecName = parser.value("codec");
+    params.fCodec = avcodec_find_encoder_by_name(codecName.toUtf8().data());
+    if(!params.fCodec) RuntimeThrow("Unknown encoder " + codecName);
+    const auto size = parser.value("size").split('x');
+    if(size.count() != 2) RuntimeThrow("Invalid size " + parser.value("size"));
+    params.fWidth = size.first().toInt() & ~1;
+    params.fHeight = size.last().toInt() & ~1;
+    params.fFrames = qMax(1, parser.value("frames").toInt());
+    params.fBitrate = qRound(parser.value("bitrate").toDouble()*1000000);
+    const int threads = qMax(0, parser.value("video-threads").toInt());
+
+    QTextStream out(stdout);
+    out << codecName << " " << params.fWidth << "x" << params.fHeight
+        << ", " << params.fFrames << " frames" << endl;
+    const qreal before = encodeFps(params, false, 1);
+    out << "  flush per frame, 1 thread: " << before << " fps" << endl;
+    const qreal after = encodeFps(params, true, threads);
+    out << "  continuous, " << (threads ? QString::number(threads) : "auto")
+        << " threads: " << after << " fps" << endl;
+    if(before > 0) out << "  speedup: " << after/before << "x" << endl;
+    return 0;
+}
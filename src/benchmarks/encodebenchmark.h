@@ -14,20 +14,14 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#ifndef TMPFILEHANDLERS_H
-#define TMPFILEHANDLERS_H
-#include "Tasks/updatable.h"
-#include <QTemporaryFile>
+#ifndef ENCODEBENCHMARK_H
+#define ENCODEBENCHMARK_H
 
-class CORE_EXPORT TmpDeleter : public eHddTask {
-    e_OBJECT
-protected:
-    TmpDeleter(const qsptr<QTemporaryFile> &file);
-public:
-    void process();
-private:
-    qsptr<QTemporaryFile> mTmpFile;
-};
+#include <QStringList>
 
+//! @brief Times encoding of synthetic frames the way VideoEncoder used to,
+//! on one thread with a codec flush after every frame,
+//! and the way it does now, continuously with codec threading.
+int encodeBenchmark(const QStringList& args);
 
-#endif // TMPFILEHANDLERS_H
+#endif // ENCODEBENCHMARK_H
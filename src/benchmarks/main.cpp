@@ -0,0 +1,63 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <QCoreApplication>
+#include <QTextStream>
+
+#include "exceptions.h"
+#include "encodebenchmark.h"
+#include "mixbenchmark.h"
+#include "pixelkernelsbenchmark.h"
+
+struct Benchmark {
+    const char* fName;
+    const char* fDescription;
+    int (*fRun)(const QStringList& args);
+};
+
+static const Benchmark gBenchmarks[] = {
+    {"encode", "video encoding fps, per-frame flushes versus continuous",
+     encodeBenchmark},
+    {"mix", "sound mixing for each sample format, per sample versus float bus",
+     mixBenchmark},
+    {"pixel", "cpu path of the built-in pixel effects on 1080p and 4K frames",
+     pixelKernelsBenchmark},
+    {"pixel-check", "pixel kernels within 1 LSB of the scalar effect code",
+     pixelKernelsCheck}
+};
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    // the benchmark sees the remaining arguments as its own command line
+    QStringList args = app.arguments();
+    const QString name = args.count() > 1 ? args.takeAt(1) : QString();
+    for(const auto& benchmark : gBenchmarks) {
+        if(name != benchmark.fName) continue;
+        try {
+            return benchmark.fRun(args);
+        } catch(const std::exception& e) {
+            QTextStream(stderr) << gAllTextFromException(e) << endl;
+            return 1;
+        }
+    }
+    QTextStream out(stdout);
+    out << "Usage: enve-benchmarks <benchmark> [--help] [options]" << endl;
+    for(const auto& benchmark : gBenchmarks) {
+        out << "  " << benchmark.fName << "\t"
+            << benchmark.fDescription << endl;
+    }
+    return name.isEmpty() || name == "--help" ? 0 : 1;
+}
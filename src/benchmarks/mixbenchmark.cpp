@@ -0,0 +1,232 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "mixbenchmark.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QVarLengthArray>
+#include <QVector>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Sound/mixkernels.h"
+#include "RasterEffects/pixelkernels.h"
+
+using Isa = PixelKernels::Isa;
+
+// the same ramp length as SoundMerger
+static const int sRampLength = 64;
+
+struct MixParams {
+    AVSampleFormat fFormat;
+    int fChannels;
+    int fSamples;
+    int fSounds;
+};
+
+//! @brief Buffers of one sound, one per channel for planar formats.
+struct SoundData {
+    std::vector<std::vector<uchar>> fPlanes;
+    std::vector<uchar*> fData;
+
+    SoundData(const MixParams& params, std::mt19937& gen) {
+        const int n = params.fSamples;
+        const int nChannels = params.fChannels;
+        const bool planar = av_sample_fmt_is_planar(params.fFormat);
+        const int nPlanes = planar ? nChannels : 1;
+        const int bytes = av_get_bytes_per_sample(params.fFormat)*
+                n*(planar ? 1 : nChannels);
+        for(int i = 0; i < nPlanes; i++) {
+            fPlanes.emplace_back(static_cast<size_t>(bytes));
+            fData.push_back(fPlanes.back().data());
+        }
+        std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+        std::vector<float> samples(static_cast<size_t>(n*nChannels));
+        for(auto& sample : samples) sample = dist(gen);
+        std::vector<float*> channels;
+        for(int j = 0; j < nChannels; j++) {
+            channels.push_back(samples.data() + j*n);
+        }
+        MixKernels::writeFromFloat(channels.data(), fData.data(),
+                                   n, params.fFormat, nChannels);
+    }
+};
+
+static qreal volume(const int sample) {
+    return 0.5 + 0.25*std::sin(sample*0.001);
+}
+
+template <typename T>
+static void mixPrevious(const T* src, T* dst, const int n,
+                        const int nChannels, const qreal shift) {
+    const qreal min = std::numeric_limits<T>::lowest();
+    const qreal max = std::numeric_limits<T>::max();
+    const bool integer = std::numeric_limits<T>::is_integer;
+    for(int i = 0; i < n; i++) {
+        const qreal vol = volume(i);
+        for(int j = 0; j < nChannels; j++) {
+            T& dstP = *dst++;
+            const qreal v = dstP + (*src++ - shift)*vol;
+            dstP = integer ? T(qBound(min, std::round(v), max)) : T(v);
+        }
+    }
+}
+
+//! @brief Per sample and channel with qreal math, like SoundMerger used to.
+static void mixSoundPrevious(const SoundData& sound, uchar ** const dst,
+                             const MixParams& params) {
+    const bool planar = av_sample_fmt_is_planar(params.fFormat);
+    const int n = params.fSamples;
+    const int nChannels = planar ? 1 : params.fChannels;
+    for(size_t p = 0; p < sound.fData.size(); p++) {
+        const uchar* const src = sound.fData[p];
+        switch(av_get_packed_sample_fmt(params.fFormat)) {
+        case AV_SAMPLE_FMT_U8:
+            mixPrevious(src, dst[p], n, nChannels, 128);
+            break;
+        case AV_SAMPLE_FMT_S16:
+            mixPrevious(reinterpret_cast<const qint16*>(src),
+                        reinterpret_cast<qint16*>(dst[p]), n, nChannels, 0);
+            break;
+        case AV_SAMPLE_FMT_S32:
+            mixPrevious(reinterpret_cast<const qint32*>(src),
+                        reinterpret_cast<qint32*>(dst[p]), n, nChannels, 0);
+            break;
+        case AV_SAMPLE_FMT_S64:
+            mixPrevious(reinterpret_cast<const qint64*>(src),
+                        reinterpret_cast<qint64*>(dst[p]), n, nChannels, 0);
+            break;
+        case AV_SAMPLE_FMT_FLT:
+            mixPrevious(reinterpret_cast<const float*>(src),
+                        reinterpret_cast<float*>(dst[p]), n, nChannels, 0);
+            break;
+        case AV_SAMPLE_FMT_DBL:
+            mixPrevious(reinterpret_cast<const qreal*>(src),
+                        reinterpret_cast<qreal*>(dst[p]), n, nChannels, 0);
+            break;
+        default: break;
+        }
+    }
+}
+
+//! @brief Sums on a planar float bus with gain ramps, like SoundMerger.
+static void mixSoundsOnBus(const std::vector<SoundData>& sounds,
+                           uchar ** const dst, const MixParams& params) {
+    const int n = params.fSamples;
+    const int nChannels = params.fChannels;
+    QVector<float> busData(n*nChannels, 0.f);
+    QVector<float> scratch(n*nChannels);
+    QVarLengthArray<float*, 8> bus(nChannels);
+    QVarLengthArray<float*, 8> src(nChannels);
+    for(int j = 0; j < nChannels; j++) {
+        bus[j] = busData.data() + j*n;
+        src[j] = scratch.data() + j*n;
+    }
+    for(const auto& sound : sounds) {
+        MixKernels::readToFloat(sound.fData.data(), 0, src.data(),
+                                n, params.fFormat, nChannels);
+        for(int i = 0; i < n; i += sRampLength) {
+            const int len = qMin(sRampLength, n - i);
+            const qreal gain0 = volume(i);
+            const qreal gain1 = volume(i + len);
+            const float gain = static_cast<float>(gain0);
+            const float gainStep = static_cast<float>((gain1 - gain0)/len);
+            for(int j = 0; j < nChannels; j++) {
+                MixKernels::mixRamp(bus[j] + i, src[j] + i,
+                                    len, gain, gainStep);
+            }
+        }
+    }
+    MixKernels::writeFromFloat(bus.data(), dst, n, params.fFormat, nChannels);
+}
+
+template <typename Func>
+static qreal bestOfMs(const int runs, const Func& func) {
+    qint64 bestNs = -1;
+    for(int run = 0; run < runs; run++) {
+        QElapsedTimer timer;
+        timer.start();
+        func();
+        const qint64 ns = timer.nsecsElapsed();
+        if(bestNs < 0 || ns < bestNs) bestNs = ns;
+    }
+    return bestNs/1e6;
+}
+
+int mixBenchmark(const QStringList& args) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times mixing sounds "
+                                     "for each sample format");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"sounds", "Number of mixed sounds.", "n", "16"},
+        {"seconds", "Length of each sound.", "s", "10"},
+        {"sample-rate", "Sample rate.", "hz", "48000"},
+        {"channels", "Number of channels.", "n", "2"},
+        {"runs", "Runs per measurement, the best one is reported.", "n", "3"}
+    });
+    parser.process(args);
+    const int runs = qMax(1, parser.value("runs").toInt());
+    const int sampleRate = qMax(1, parser.value("sample-rate").toInt());
+    const int seconds = qMax(1, parser.value("seconds").toInt());
+
+    MixParams params;
+    params.fSounds = qMax(1, parser.value("sounds").toInt());
+    params.fChannels = qBound(1, parser.value("channels").toInt(), 8);
+    params.fSamples = sampleRate*seconds;
+
+    const AVSampleFormat formats[] = {
+        AV_SAMPLE_FMT_U8, AV_SAMPLE_FMT_S16, AV_SAMPLE_FMT_S32,
+        AV_SAMPLE_FMT_S64, AV_SAMPLE_FMT_FLT, AV_SAMPLE_FMT_DBL,
+        AV_SAMPLE_FMT_U8P, AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_S32P,
+        AV_SAMPLE_FMT_S64P, AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP
+    };
+    QList<Isa> isas{Isa::sse41};
+    if(PixelKernels::supportedIsa() == Isa::avx2) isas << Isa::avx2;
+
+    QTextStream out(stdout);
+    out << params.fSounds << " sounds, " << seconds << " s, "
+        << sampleRate << " Hz, " << params.fChannels << " channels" << endl;
+    std::mt19937 gen(1);
+    for(const auto format : formats) {
+        params.fFormat = format;
+        std::vector<SoundData> sounds;
+        for(int i = 0; i < params.fSounds; i++) sounds.emplace_back(params, gen);
+        SoundData result(params, gen);
+
+        out << av_get_sample_fmt_name(format) << endl;
+        const qreal previousMs = bestOfMs(runs, [&]() {
+            for(const auto& sound : sounds) {
+                mixSoundPrevious(sound, result.fData.data(), params);
+            }
+        });
+        out << "  per sample: " << previousMs << " ms" << endl;
+        for(const Isa isa : isas) {
+            PixelKernels::limitIsa(isa);
+            const qreal ms = bestOfMs(runs, [&]() {
+                mixSoundsOnBus(sounds, result.fData.data(), params);
+            });
+            out << "  float bus, " << (isa == Isa::avx2 ? "avx" : "sse")
+                << ": " << ms << " ms, " << previousMs/ms << "x" << endl;
+        }
+        PixelKernels::limitIsa(PixelKernels::supportedIsa());
+    }
+    return 0;
+}
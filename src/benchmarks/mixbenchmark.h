@@ -14,11 +14,13 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
-#include "tmpdeleter.h"
-#include "imagecachecontainer.h"
-#include "skia/skiahelpers.h"
+#ifndef MIXBENCHMARK_H
+#define MIXBENCHMARK_H
 
-TmpDeleter::TmpDeleter(const qsptr<QTemporaryFile> &file) :
-    mTmpFile(file) {}
+#include <QStringList>
 
-void TmpDeleter::process() { mTmpFile.reset(); }
+//! @brief Times mixing several sounds for each AVSampleFormat,
+//! per sample as SoundMerger used to and on the float bus it uses now.
+int mixBenchmark(const QStringList& args);
+
+#endif // MIXBENCHMARK_H
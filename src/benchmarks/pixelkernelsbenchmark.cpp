@@ -0,0 +1,296 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pixelkernelsbenchmark.h"
+
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QSize>
+#include <QTextStream>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "RasterEffects/pixelkernels.h"
+#include "colorhelpers.h"
+
+using Isa = PixelKernels::Isa;
+using Pixels = std::vector<uchar>;
+using RowFunc = std::function<void(const uchar* src, uchar* dst,
+                                   const int count)>;
+
+struct PixelEffect {
+    QString fName;
+    RowFunc fScalar;
+    RowFunc fKernel;
+};
+
+static QString isaName(const Isa isa) {
+    switch(isa) {
+    case Isa::avx2: return "avx2";
+    case Isa::sse41: return "sse4.1";
+    default: return "scalar";
+    }
+}
+
+static QList<Isa> supportedIsas() {
+    QList<Isa> result{Isa::scalar};
+    const Isa best = PixelKernels::supportedIsa();
+    if(best >= Isa::sse41) result << Isa::sse41;
+    if(best >= Isa::avx2) result << Isa::avx2;
+    return result;
+}
+
+static Pixels randomPixels(const int count, std::mt19937& gen) {
+    Pixels result(static_cast<size_t>(4*count));
+    for(int i = 0; i < count; i++) {
+        const uint a = gen() % 256;
+        for(int c = 0; c < 3; c++) {
+            result[static_cast<size_t>(4*i + c)] =
+                    static_cast<uchar>(a ? gen() % (a + 1) : 0);
+        }
+        result[static_cast<size_t>(4*i + 3)] = static_cast<uchar>(a);
+    }
+    return result;
+}
+
+// the scalar functions repeat the per pixel loops of the effect callers
+
+static void brightnessContrastScalar(const uchar* src, uchar* dst,
+                                     const int count,
+                                     const qreal brightness,
+                                     const qreal contrast) {
+    const auto channel = [&](const uchar c, const uchar a) {
+        const qreal v = (c - 0.5*a)*(contrast + 1.) + a*(0.5 + brightness);
+        return static_cast<uchar>(qBound(0., v, 255.));
+    };
+    for(int i = 0; i < count; i++) {
+        const uchar a = src[3];
+        for(int c = 0; c < 3; c++) *dst++ = channel(*src++, a);
+        *dst++ = *src++;
+    }
+}
+
+static void colorizeScalar(const uchar* src, uchar* dst, const int count,
+                           const qreal hue, const qreal saturation,
+                           const qreal lightness, const qreal influence) {
+    for(int i = 0; i < count; i++) {
+        const uchar texA = src[3];
+        const qreal texRF = *src++/255.;
+        const qreal texGF = *src++/255.;
+        const qreal texBF = *src++/255.;
+        const qreal texAF = *src++/255.;
+        if(texA == 0) {
+            for(int j = 0; j < 4; j++) *dst++ = 0;
+            continue;
+        }
+        qreal h = texRF/texAF;
+        qreal s = texGF/texAF;
+        qreal l = texBF/texAF;
+        qrgb_to_hsl(h, s, l);
+        h = hue;
+        s = saturation;
+        l = qBound(0., l + lightness, 1.);
+        qhsl_to_rgb(h, s, l);
+
+        *dst++ = static_cast<uchar>(255*(h*texAF*influence + texRF*(1 - influence)));
+        *dst++ = static_cast<uchar>(255*(s*texAF*influence + texGF*(1 - influence)));
+        *dst++ = static_cast<uchar>(255*(l*texAF*influence + texBF*(1 - influence)));
+        *dst++ = texA;
+    }
+}
+
+static void scaleScalar(const uchar* src, uchar* dst,
+                        const float* factors, const int count) {
+    for(int i = 0; i < count; i++) {
+        const float factor = factors[i];
+        for(int j = 0; j < 4; j++) *dst++ = static_cast<uchar>(*src++ * factor);
+    }
+}
+
+static PixelEffect brightnessContrastEffect(const qreal brightness,
+                                            const qreal contrast) {
+    const RowFunc scalar = [brightness, contrast](
+            const uchar* src, uchar* dst, const int count) {
+        brightnessContrastScalar(src, dst, count, brightness, contrast);
+    };
+    const RowFunc kernel = [brightness, contrast, scalar](
+            const uchar* src, uchar* dst, const int count) {
+        const int done = PixelKernels::brightnessContrast(
+                    src, dst, count, static_cast<float>(brightness),
+                    static_cast<float>(contrast));
+        scalar(src + 4*done, dst + 4*done, count - done);
+    };
+    return {QString("brightness/contrast %1 %2").arg(brightness).arg(contrast),
+            scalar, kernel};
+}
+
+static PixelEffect colorizeEffect(const qreal hue, const qreal saturation,
+                                  const qreal lightness,
+                                  const qreal influence) {
+    const RowFunc scalar = [=](const uchar* src, uchar* dst, const int count) {
+        colorizeScalar(src, dst, count, hue, saturation, lightness, influence);
+    };
+    const PixelKernels::ColorizeParams params(hue, saturation,
+                                              lightness, influence);
+    const RowFunc kernel = [params, scalar](
+            const uchar* src, uchar* dst, const int count) {
+        const int done = PixelKernels::colorize(src, dst, count, params);
+        scalar(src + 4*done, dst + 4*done, count - done);
+    };
+    return {QString("colorize %1 %2 %3 %4").arg(hue).arg(saturation).
+            arg(lightness).arg(influence), scalar, kernel};
+}
+
+//! @brief Used by noise fade and wipe with their per pixel factors.
+static PixelEffect scaleEffect(const std::vector<float>& factors) {
+    const RowFunc scalar = [factors](const uchar* src, uchar* dst,
+                                     const int count) {
+        scaleScalar(src, dst, factors.data(), count);
+    };
+    const RowFunc kernel = [factors](const uchar* src, uchar* dst,
+                                     const int count) {
+        const int done = PixelKernels::scale(src, dst, factors.data(), count);
+        scaleScalar(src + 4*done, dst + 4*done,
+                    factors.data() + done, count - done);
+    };
+    return {"scale (noise fade, wipe)", scalar, kernel};
+}
+
+static std::vector<float> randomFactors(const int count, std::mt19937& gen) {
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    std::vector<float> result(static_cast<size_t>(count));
+    for(auto& factor : result) factor = dist(gen);
+    return result;
+}
+
+//! @brief Best of runs, in milliseconds for the whole frame.
+static qreal timeFrame(const RowFunc& func, const Pixels& src, Pixels& dst,
+                       const int width, const int height, const int runs) {
+    qint64 bestNs = -1;
+    for(int run = 0; run < runs; run++) {
+        QElapsedTimer timer;
+        timer.start();
+        for(int y = 0; y < height; y++) {
+            const size_t rowOffset = static_cast<size_t>(4*width*y);
+            func(src.data() + rowOffset, dst.data() + rowOffset, width);
+        }
+        const qint64 ns = timer.nsecsElapsed();
+        if(bestNs < 0 || ns < bestNs) bestNs = ns;
+    }
+    return bestNs/1e6;
+}
+
+int pixelKernelsBenchmark(const QStringList& args) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Times the cpu path of the built-in "
+                                     "pixel effects on full frames");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"runs", "Runs per measurement, the best one is reported.", "n", "5"}
+    });
+    parser.process(args);
+    const int runs = qMax(1, parser.value("runs").toInt());
+
+    QTextStream out(stdout);
+    std::mt19937 gen(1);
+    const QList<QSize> sizes{{1920, 1080}, {3840, 2160}};
+    for(const auto& size : sizes) {
+        const int width = size.width();
+        const int height = size.height();
+        const Pixels src = randomPixels(width*height, gen);
+        Pixels dst(src.size());
+        const QList<PixelEffect> effects{
+            brightnessContrastEffect(0.2, 0.5),
+            colorizeEffect(0.6, 0.8, 0.1, 0.9),
+            scaleEffect(randomFactors(width, gen))
+        };
+        out << width << "x" << height << endl;
+        for(const auto& effect : effects) {
+            out << "  " << effect.fName << endl;
+            const qreal scalarMs = timeFrame(effect.fScalar, src, dst,
+                                             width, height, runs);
+            out << "    previous scalar: " << scalarMs << " ms" << endl;
+            for(const Isa isa : supportedIsas()) {
+                if(isa == Isa::scalar) continue;
+                PixelKernels::limitIsa(isa);
+                const qreal ms = timeFrame(effect.fKernel, src, dst,
+                                           width, height, runs);
+                out << "    " << isaName(isa) << ": " << ms << " ms, "
+                    << scalarMs/ms << "x" << endl;
+            }
+            PixelKernels::limitIsa(PixelKernels::supportedIsa());
+        }
+    }
+    return 0;
+}
+
+int pixelKernelsCheck(const QStringList& args) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the pixel kernels with the "
+                                     "scalar code of the effect callers");
+    parser.addHelpOption();
+    parser.process(args);
+
+    // an odd count leaves a tail for the scalar code
+    const int count = 65536 + 7;
+    std::mt19937 gen(1);
+    const Pixels src = randomPixels(count, gen);
+    QList<PixelEffect> effects;
+    for(qreal b = -1; b <= 1; b += 0.37) {
+        for(qreal c = -1; c <= 1; c += 0.29) {
+            effects << brightnessContrastEffect(b, c);
+        }
+    }
+    for(qreal hue = -30; hue < 400; hue += 47) {
+        for(qreal s = 0; s <= 1; s += 0.3) {
+            for(qreal l = -1; l <= 1; l += 0.45) {
+                for(qreal i = 0; i <= 1; i += 0.5) {
+                    effects << colorizeEffect(hue/360, s, l, i);
+                }
+            }
+        }
+    }
+    effects << scaleEffect(randomFactors(count, gen));
+
+    QTextStream out(stdout);
+    bool passed = true;
+    Pixels expected(src.size());
+    Pixels result(src.size());
+    for(const Isa isa : supportedIsas()) {
+        PixelKernels::limitIsa(isa);
+        int worst = 0;
+        for(const auto& effect : effects) {
+            effect.fScalar(src.data(), expected.data(), count);
+            effect.fKernel(src.data(), result.data(), count);
+            int effectWorst = 0;
+            for(size_t i = 0; i < src.size(); i++) {
+                const int diff = qAbs(expected[i] - result[i]);
+                effectWorst = qMax(effectWorst, diff);
+            }
+            if(effectWorst > 1) {
+                out << "  " << isaName(isa) << " " << effect.fName
+                    << " differs by " << effectWorst << endl;
+            }
+            worst = qMax(worst, effectWorst);
+        }
+        out << isaName(isa) << ": worst difference " << worst << endl;
+        if(worst > 1) passed = false;
+    }
+    PixelKernels::limitIsa(PixelKernels::supportedIsa());
+    out << (passed ? "PASSED" : "FAILED") << endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PIXELKERNELSBENCHMARK_H
+#define PIXELKERNELSBENCHMARK_H
+
+#include <QStringList>
+
+//! @brief Times the cpu path of the built-in pixel effects
+//! with each supported instruction set on full frames.
+int pixelKernelsBenchmark(const QStringList& args);
+
+//! @brief Compares PixelKernels with the scalar code of the effect callers
+//! for each supported instruction set, fails above 1 LSB difference.
+int pixelKernelsCheck(const QStringList& args);
+
+#endif // PIXELKERNELSBENCHMARK_H
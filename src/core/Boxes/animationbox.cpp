@@ -31,6 +31,8 @@
 #include "Private/Tasks/taskscheduler.h"
 #include "GUI/dialogsinterface.h"
 #include "svgexporter.h"
+#include "FileCacheHandlers/videocachehandler.h"
+#include "FileCacheHandlers/proxymedia.h"
 
 struct AnimationBoxRenderData : public ImageContainerRenderData {
     AnimationBoxRenderData(AnimationFrameHandler *cacheHandler,
@@ -38,7 +40,7 @@ struct AnimationBoxRenderData : public ImageContainerRenderData {
 
     void loadImageFromHandler();
 
-    const qptr<AnimationFrameHandler> fSrcCacheHandler;
+    qptr<AnimationFrameHandler> fSrcCacheHandler;
     int fAnimFrame;
 };
 
@@ -133,6 +135,14 @@ void AnimationBox::setAnimationFramesHandler(const qsptr<AnimationFrameHandler>&
     mSrcFramesCache = src;
 }
 
+void AnimationBox::setProxyMedia(ProxyMedia * const proxy) {
+    const auto proxyData = proxy ? proxy->dataHandler() : nullptr;
+    if(proxyData) {
+        mProxyFramesCache = enve::make_shared<VideoFrameHandler>(proxyData);
+    } else mProxyFramesCache.reset();
+    prp_afterWholeInfluenceRangeChanged();
+}
+
 void AnimationBox::anim_setAbsFrame(const int frame) {
     BoundingBox::anim_setAbsFrame(frame);
     if(!mSrcFramesCache) return;
@@ -238,6 +248,12 @@ void AnimationBox::setupCanvasMenu(PropertyMenu * const menu) {
     };
     menu->addPlainAction("Stretch...", stretchOp);
 
+    const PropertyMenu::PlainSelectedOp<AnimationBox> proxyOp =
+    [](AnimationBox * box) {
+        box->createProxy();
+    };
+    menu->addPlainAction("Create Proxy", proxyOp);
+
     menu->addSeparator();
     const PropertyMenu::PlainSelectedOp<AnimationBox> createPaintObj =
     [](AnimationBox * box) {
@@ -300,10 +316,22 @@ void AnimationBox::setupRenderData(const qreal relFrame,
     const auto imgData = static_cast<AnimationBoxRenderData*>(data);
     const int animFrame = getAnimationFrameForRelFrame(relFrame);
     imgData->fAnimFrame = animFrame;
-    const auto upd = mSrcFramesCache->scheduleFrameLoad(animFrame);
+    AnimationFrameHandler* src = mSrcFramesCache.get();
+    if(mProxyFramesCache && ProxyMedia::sUseProxy(scene) &&
+       animFrame < mProxyFramesCache->getFrameCount()) {
+        src = mProxyFramesCache.get();
+        imgData->fImageScale = ProxyMedia::sScale;
+    }
+    imgData->fSrcCacheHandler = src;
+    if(scene && scene->isRenderingOutput()) {
+        // output frames come in order, decode ahead in a single pass
+        const int decodeAhead = 32;
+        src->scheduleFrameRangeLoad({animFrame, animFrame + decodeAhead - 1});
+    }
+    const auto upd = src->scheduleFrameLoad(animFrame);
     if(upd) upd->addDependent(imgData);
     else {
-        const auto cont = mSrcFramesCache->getFrameAtFrame(animFrame);
+        const auto cont = src->getFrameAtFrame(animFrame);
         imgData->setContainer(cont);
     }
 }
@@ -23,6 +23,7 @@
 #include "imagebox.h"
 
 class AnimationFrameHandler;
+class ProxyMedia;
 class IntFrameRemapping;
 
 class CORE_EXPORT AnimationBox : public BoundingBox {
@@ -31,6 +32,8 @@ protected:
     AnimationBox(const QString& name, const eBoxType type);
 public:
     virtual void changeSourceFile() = 0;
+    //! @brief Generates a low resolution copy of the source in the background.
+    virtual void createProxy() = 0;
     void animationDataChanged();
     virtual void setStretch(const qreal stretch) {
         mStretch = stretch;
@@ -65,6 +68,7 @@ public:
     void reload();
 protected:
     void setAnimationFramesHandler(const qsptr<AnimationFrameHandler>& src);
+    void setProxyMedia(ProxyMedia * const proxy);
 private:
     void createPaintObject(const int firstAbsFrame,
                            const int lastAbsFrame,
@@ -72,6 +76,7 @@ private:
 
     qreal mStretch = 1;
     qsptr<AnimationFrameHandler> mSrcFramesCache;
+    qsptr<AnimationFrameHandler> mProxyFramesCache;
     qsptr<IntFrameRemapping> mFrameRemapping;
 };
 
@@ -1252,6 +1252,15 @@ void BoundingBox::renderDataFinished(BoxRenderData *renderData) {
     }
 }
 
+void BoundingBox::renderDataCanceled(BoxRenderData *renderData,
+                                     const bool requeue) {
+    const qreal relFrame = renderData->fRelFrame;
+    if(mRenderDataHandler.getItemAtRelFrame(relFrame) != renderData) return;
+    mRenderDataHandler.removeItemAtRelFrame(relFrame);
+    // canceled before processing, e.g. stale after a frame change
+    if(requeue) planUpdate(UpdateReason::frameChange);
+}
+
 //QString skBlendModeToSVG(const SkBlendMode mode) {
 //    switch(mode) {
 //    case SkBlendMode::kMultiply:    return "multiply";
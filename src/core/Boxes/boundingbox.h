@@ -196,6 +196,7 @@ public:
                                  BoxRenderData * const data,
                                  Canvas * const scene);
     virtual void renderDataFinished(BoxRenderData *renderData);
+    void renderDataCanceled(BoxRenderData *renderData, const bool requeue);
     virtual void updateCurrentPreviewDataFromRenderData(
             BoxRenderData* renderData);
 
@@ -17,9 +17,15 @@
 #include "boxrenderdata.h"
 #include "boundingbox.h"
 #include "skia/skiahelpers.h"
+#include "skia/pixelbufferpool.h"
 #include "efiltersettings.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/gputaskexecutor.h"
+#include "Private/Tasks/taskexecutor.h"
+
+#include <QThread>
+#include <QElapsedTimer>
+#include <atomic>
 
 BoxRenderData::BoxRenderData(BoundingBox * const parent) :
     fFilterQuality(eFilterSettings::sRender()) {
@@ -33,6 +39,11 @@ void BoxRenderData::transformRenderCanvas(SkCanvas &canvas) const {
     canvas.concat(toSkMatrix(fScaledTransform));
 }
 
+void BoxRenderData::rasterize(SkCanvas& canvas) {
+    transformRenderCanvas(canvas);
+    drawSk(&canvas);
+}
+
 void BoxRenderData::copyFrom(BoxRenderData *src) {
     mCopySource = src;
     fRelTransform = src->fRelTransform;
@@ -118,9 +129,9 @@ void BoxRenderData::processGpu(QGL33 * const gl,
                 kRGBA_8888_SkColorType, nullptr, nullptr);
 
     const auto canvas = surf->getCanvas();
-    transformRenderCanvas(*canvas);
     canvas->clear(eraseColor());
-    drawSk(canvas);
+    beforeRasterize();
+    rasterize(*canvas);
     canvas->flush();
     fRenderedImage = SkImage::MakeFromAdoptedTexture(grContext, grTex,
                                                      kTopLeft_GrSurfaceOrigin,
@@ -144,19 +155,76 @@ void BoxRenderData::process() {
 
     const auto info = SkiaHelpers::getPremulRGBAInfo(fGlobalRect.width(),
                                                      fGlobalRect.height());
-    mBitmap.allocPixels(info);
+    // erased below or by each of the tiles
+    PixelBufferPool::sAllocPixels(mBitmap, info, false);
+    beforeRasterize();
+    // tiles get spawned in nextStep
+    mRasterTiles = rasterTileCount();
+    if(mRasterTiles > 1) return;
     mBitmap.eraseColor(eraseColor());
     SkCanvas canvas(mBitmap);
-    transformRenderCanvas(canvas);
+    rasterize(canvas);
 
-    drawSk(&canvas);
+    fRenderedImage = SkiaHelpers::transferDataToSkImage(mBitmap);
+}
+
+int BoxRenderData::rasterTileCount() const {
+    if(!tileable()) return 1;
+    // smaller tiles do not make up for the scheduling
+    const qint64 minTileArea = 512*512;
+    const qint64 area = qint64(fGlobalRect.width())*fGlobalRect.height();
+    const int nThreads = QThread::idealThreadCount();
+    return static_cast<int>(qBound(qint64(1), area/minTileArea,
+                                   qint64(nThreads)));
+}
 
+void BoxRenderData::spawnRasterTiles(const int count) {
+    const auto data = ref<BoxRenderData>();
+    const auto remaining = std::make_shared<int>(count);
+    const auto tilesTimeUs = std::make_shared<std::atomic<qint64>>(0);
+    const auto tileDone = [data, remaining, tilesTimeUs]() {
+        if(--*remaining > 0) return;
+        // tiles are timed apart from the steps of this task
+        data->addProcessingTime(*tilesTimeUs);
+        data->rasterTilesFinished();
+    };
+    // horizontal bands, each thread gets contiguous rows
+    const int width = fGlobalRect.width();
+    const int height = fGlobalRect.height();
+    for(int i = 0; i < count; i++) {
+        const int top = height*i/count;
+        const int bottom = height*(i + 1)/count;
+        const auto tile = SkIRect::MakeLTRB(0, top, width, bottom);
+        const auto task = enve::make_shared<eCustomCpuTask>(
+                    nullptr, [data, tile, tilesTimeUs]() {
+                        QElapsedTimer timer;
+                        timer.start();
+                        data->rasterizeTile(tile);
+                        *tilesTimeUs += timer.nsecsElapsed()/1000;
+                    }, tileDone, tileDone);
+        CpuTaskExecutor::sAddTask(task);
+    }
+}
+
+void BoxRenderData::rasterizeTile(const SkIRect& tile) {
+    SkBitmap tileBitmap;
+    if(!mBitmap.extractSubset(&tileBitmap, tile)) return;
+    tileBitmap.eraseColor(eraseColor());
+    SkCanvas canvas(tileBitmap);
+    canvas.translate(-tile.x(), -tile.y());
+    rasterize(canvas);
+}
+
+void BoxRenderData::rasterTilesFinished() {
+    if(getState() == eTaskState::canceled) return mBitmap.reset();
     fRenderedImage = SkiaHelpers::transferDataToSkImage(mBitmap);
+    if(!nextStep()) finishedProcessing();
 }
 
 void BoxRenderData::beforeProcessing(const Hardware hw) {
     Q_UNUSED(hw)
     Q_ASSERT(mStep != Step::EFFECTS);
+    mProcessingStarted = true;
     setupRenderData();
     if(!mDataSet) dataSet();
     if(isZero4Dec(fOpacity)) finishedProcessing();
@@ -173,6 +241,12 @@ void BoxRenderData::afterProcessing() {
     }
 }
 
+void BoxRenderData::afterCanceled() {
+    if(fParentBox && fParentIsTarget) {
+        fParentBox->renderDataCanceled(this, !mProcessingStarted);
+    }
+}
+
 void BoxRenderData::afterQued() {
     if(mDataSet) return;
     if(!mDelayDataSet) dataSet();
@@ -194,6 +268,12 @@ void BoxRenderData::queTaskNow() {
 }
 
 bool BoxRenderData::nextStep() {
+    if(mRasterTiles > 1) {
+        const int count = mRasterTiles;
+        mRasterTiles = 0;
+        spawnRasterTiles(count);
+        return true;
+    }
     const bool result = !mEffectsRenderer.isEmpty() &&
                         fRenderedImage;
     if(result) {
@@ -36,6 +36,13 @@ protected:
     BoxRenderData(BoundingBox * const parent);
 
     virtual void drawSk(SkCanvas * const canvas) = 0;
+    //! @brief Called once before rasterize, which may then run
+    //! concurrently for separate tiles if tileable.
+    virtual void beforeRasterize() {}
+    //! @brief Draws on a canvas covering fGlobalRect cleared with eraseColor.
+    virtual void rasterize(SkCanvas& canvas);
+    //! @brief Whether large data can be rasterized in parallel tiles.
+    virtual bool tileable() const { return false; }
     virtual void updateRelBoundingRect() = 0;
     virtual void setupRenderData() {}
     virtual void transformRenderCanvas(SkCanvas& canvas) const;
@@ -44,7 +51,7 @@ protected:
 
     HardwareSupport hardwareSupport() const;
 
-    void afterCanceled() {}
+    void afterCanceled();
     void beforeProcessing(const Hardware hw) final;
     void afterProcessing();
     void afterQued();
@@ -68,6 +75,18 @@ public:
 
     bool nextStep();
 
+    //! @brief Processing time including the children render data.
+    virtual qint64 totalProcessingTimeUs() const
+    { return processingTimeUs(); }
+    //! @brief Pixels re-composited including the children render data.
+    virtual qint64 totalPixelsComposited() const { return 0; }
+
+    //! @brief The render data this one was copied from, or itself.
+    BoxRenderData* origin() {
+        const auto src = mCopySource.get();
+        return src ? src : this;
+    }
+
     void processGpu(QGL33 * const gl, SwitchableContext &context);
     void process();
 
@@ -130,7 +149,14 @@ private:
         mImageCopies << img;
     }
 
+    int rasterTileCount() const;
+    void spawnRasterTiles(const int count);
+    void rasterizeTile(const SkIRect& tile);
+    void rasterTilesFinished();
+
     Step mStep = Step::BOX_IMAGE;
+    bool mProcessingStarted = false;
+    int mRasterTiles = 0;
     EffectsRenderer mEffectsRenderer;
     stdptr<BoxRenderData> mCopySource;
     QList<sk_sp<SkImage>> mImageCopies;
@@ -980,6 +980,9 @@ void ContainerBox::setupRenderData(const qreal relFrame,
     const auto groupData = static_cast<ContainerBoxRenderData*>(data);
     groupData->fChildrenRenderData.clear();
     groupData->fOtherGlobalRects.clear();
+    // freed by the memory handler when it holds no state
+    if(mLastDrawState) groupData->fPrevDrawState = mLastDrawState->state();
+    else groupData->fPrevDrawState.reset();
     const qreal absFrame = prp_relFrameToAbsFrameF(relFrame);
     QList<ChildRenderData> delayed;
     const auto minMax = getContainedMinMax();
@@ -23,6 +23,7 @@ class PathBox;
 class PathEffectCollection;
 class BlendEffectBoxShadow;
 class FlipBookProperty;
+class ContainerDrawStateCache;
 
 class CORE_EXPORT ContainerBox : public BoxWithPathEffects {
     Q_OBJECT
@@ -137,6 +138,10 @@ public:
     void queChildrenTasks();
     void queTasks();
 
+    //! @brief Base for redrawing only the damaged area of the next render.
+    void setLastDrawState(const stdsptr<ContainerDrawStateCache>& state)
+    { mLastDrawState = state; }
+
     void writeAllContained(eWriteStream &dst) const;
     void writeAllContainedXEV(const stdsptr<XevZipFileSaver>& fileSaver,
                               const RuntimeIdToWriteId& objListIdConv,
@@ -282,6 +287,7 @@ private:
     QList<qsptr<BlendEffectBoxShadow>> mBlendShadows;
     ConnContextObjList<qsptr<eBoxOrSound>> mContained;
     qsptr<FlipBookProperty> mFlipBook;
+    stdsptr<ContainerDrawStateCache> mLastDrawState;
 };
 
 #endif // CONTAINERBOX_H
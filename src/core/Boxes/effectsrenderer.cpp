@@ -42,11 +42,22 @@ void EffectsRenderer::processGpu(QGL33 * const gl,
 }
 
 #include "effectsubtaskspawner.h"
+#include "Private/esettings.h"
 void EffectsRenderer::processCpu(BoxRenderData * const boxData) {
     const auto& effect = mEffects.at(mCurrentId++);
 
     Q_ASSERT(effect->hardwareSupport() != HardwareSupport::gpuOnly);
-    EffectSubTaskSpawner::sSpawn(effect, boxData->ref<BoxRenderData>());
+    QList<stdsptr<RasterEffectCaller>> fused{effect};
+    if(effect->pointWise() && eSettings::instance().fFuseCpuEffects) {
+        while(mCurrentId < mEffects.count()) {
+            const auto& next = mEffects.at(mCurrentId);
+            if(!next->pointWise()) break;
+            if(next->hardwareSupport() == HardwareSupport::gpuOnly) break;
+            fused << next;
+            mCurrentId++;
+        }
+    }
+    EffectSubTaskSpawner::sSpawn(fused, boxData->ref<BoxRenderData>());
 }
 
 void EffectsRenderer::setBaseGlobalRect(SkIRect &currRect,
@@ -18,16 +18,20 @@
 #include "boxrenderdata.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "skia/skiaincludes.h"
+#include "skia/pixelbufferpool.h"
 #include "RasterEffects/rastereffect.h"
 #include "RasterEffects/rastereffectcaller.h"
 #include "Private/Tasks/taskexecutor.h"
 
+#include <QElapsedTimer>
+#include <atomic>
+
 class EffectSubTaskSpawner_priv {
 public:
-    EffectSubTaskSpawner_priv(const stdsptr<RasterEffectCaller>& effect,
+    EffectSubTaskSpawner_priv(const QList<stdsptr<RasterEffectCaller>>& effects,
                               const stdsptr<BoxRenderData>& data) :
-        mUseDst(effect->srcDstSeparation()),
-        mEffectCaller(effect), mData(data) {}
+        mUseDst(effects.first()->srcDstSeparation()),
+        mEffectCallers(effects), mData(data) {}
 
     void initialize();
 private:
@@ -36,10 +40,13 @@ private:
     void splitSpawn(CpuRenderData& data,
                     const SkIRect& rect,
                     const int nSplits);
+    void processFused(const CpuRenderData& tileData);
 
     const bool mUseDst;
     int mRemaining = 0;
-    const stdsptr<RasterEffectCaller> mEffectCaller;
+    //! @brief Summed time of the sub-tasks, they are not timed with mData
+    std::atomic<qint64> mTimeUs{0};
+    const QList<stdsptr<RasterEffectCaller>> mEffectCallers;
     const stdsptr<BoxRenderData> mData;
     SkBitmap mSrcBitmap;
     SkBitmap mDstBitmap;
@@ -53,7 +60,7 @@ void EffectSubTaskSpawner_priv::initialize() {
     mSrcRasterImg = srcImg->makeRasterImage();
     mSrcRasterImg->peekPixels(&pixmap);
     mSrcBitmap.installPixels(pixmap);
-    if(mUseDst) mDstBitmap.allocPixels(mSrcBitmap.info());
+    if(mUseDst) PixelBufferPool::sAllocPixels(mDstBitmap, mSrcBitmap.info());
     spawn();
 }
 
@@ -66,14 +73,21 @@ void EffectSubTaskSpawner_priv::splitSpawn(CpuRenderData& data,
         const auto decRemaining = [this]() { decRemaining_k(); };
         const auto subTask = enve::make_shared<eCustomCpuTask>(nullptr,
             [this, data]() {
-                SkBitmap dstBitmap;
-                if(mUseDst) {
-                    mDstBitmap.extractSubset(&dstBitmap, data.fTexTile);
+                QElapsedTimer timer;
+                timer.start();
+                if(mEffectCallers.count() > 1) {
+                    processFused(data);
                 } else {
-                    mSrcBitmap.extractSubset(&dstBitmap, data.fTexTile);
+                    SkBitmap dstBitmap;
+                    if(mUseDst) {
+                        mDstBitmap.extractSubset(&dstBitmap, data.fTexTile);
+                    } else {
+                        mSrcBitmap.extractSubset(&dstBitmap, data.fTexTile);
+                    }
+                    CpuRenderTools tools{mSrcBitmap, dstBitmap};
+                    mEffectCallers.first()->processCpu(tools, data);
                 }
-                CpuRenderTools tools{mSrcBitmap, dstBitmap};
-                mEffectCaller->processCpu(tools, data);
+                mTimeUs += timer.nsecsElapsed()/1000;
             }, decRemaining, decRemaining);
         CpuTaskExecutor::sAddTask(subTask);
         return;
@@ -105,12 +119,35 @@ void EffectSubTaskSpawner_priv::splitSpawn(CpuRenderData& data,
     }
 }
 
+void EffectSubTaskSpawner_priv::processFused(const CpuRenderData& tileData) {
+    // the first effect reads the source,
+    // the following ones work in place on its output
+    const SkBitmap& target = mUseDst ? mDstBitmap : mSrcBitmap;
+    const SkIRect& tile = tileData.fTexTile;
+    // bands small enough to stay in cache between the effects
+    const int bandBytes = 128*1024;
+    const int bandRows = qMax(1, bandBytes/(4*tile.width()));
+    CpuRenderData data = tileData;
+    for(int top = tile.top(); top < tile.bottom(); top += bandRows) {
+        const int bottom = qMin(top + bandRows, tile.bottom());
+        data.fTexTile = SkIRect::MakeLTRB(tile.left(), top,
+                                          tile.right(), bottom);
+        SkBitmap dstBitmap;
+        target.extractSubset(&dstBitmap, data.fTexTile);
+        for(int i = 0; i < mEffectCallers.count(); i++) {
+            CpuRenderTools tools{i == 0 ? mSrcBitmap : target, dstBitmap};
+            mEffectCallers.at(i)->processCpu(tools, data);
+        }
+    }
+}
+
 void EffectSubTaskSpawner_priv::spawn() {
     const int width = mSrcBitmap.width();
     const int height = mSrcBitmap.height();
     const int area = width*height;
     const int nAllThreads = QThread::idealThreadCount();
-    const int nThreads = qMax(1, mEffectCaller->cpuThreads(nAllThreads, area));
+    const auto& effect = mEffectCallers.first();
+    const int nThreads = qMax(1, effect->cpuThreads(nAllThreads, area));
     mRemaining = nThreads;
 
     auto& srcImage = mData->fRenderedImage;
@@ -127,6 +164,7 @@ void EffectSubTaskSpawner_priv::spawn() {
 void EffectSubTaskSpawner_priv::decRemaining_k() {
     if(--mRemaining > 0) return;
     if(mData->getState() != eTaskState::canceled) {
+        mData->addProcessingTime(mTimeUs);
         if(mUseDst) {
             mData->fRenderedImage = SkiaHelpers::transferDataToSkImage(
                                         mDstBitmap);
@@ -145,6 +183,13 @@ void EffectSubTaskSpawner_priv::decRemaining_k() {
 
 void EffectSubTaskSpawner::sSpawn(const stdsptr<RasterEffectCaller> &effect,
                                   const stdsptr<BoxRenderData> &data) {
-    const auto spawner = new EffectSubTaskSpawner_priv(effect, data);
+    sSpawn(QList<stdsptr<RasterEffectCaller>>{effect}, data);
+}
+
+void EffectSubTaskSpawner::sSpawn(
+        const QList<stdsptr<RasterEffectCaller>>& effects,
+        const stdsptr<BoxRenderData> &data) {
+    Q_ASSERT(!effects.isEmpty());
+    const auto spawner = new EffectSubTaskSpawner_priv(effects, data);
     spawner->initialize();
 }
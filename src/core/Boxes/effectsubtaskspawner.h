@@ -18,6 +18,8 @@
 #define EFFECTSUBTASKSPAWNER_H
 #include "smartPointers/ememory.h"
 
+#include <QList>
+
 struct BoxRenderData;
 class RasterEffectCaller;
 
@@ -25,6 +27,11 @@ namespace EffectSubTaskSpawner {
     CORE_EXPORT
     void sSpawn(const stdsptr<RasterEffectCaller>& effect,
                 const stdsptr<BoxRenderData>& data);
+    //! @brief Runs point-wise effects one after another
+    //! on each band of rows, in a single pass over the image.
+    CORE_EXPORT
+    void sSpawn(const QList<stdsptr<RasterEffectCaller>>& effects,
+                const stdsptr<BoxRenderData>& data);
 };
 
 #endif // EFFECTSUBTASKSPAWNER_H
@@ -15,6 +15,8 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "imagerenderdata.h"
+#include "simplemath.h"
+#include "skia/skqtconversions.h"
 
 ImageRenderData::ImageRenderData(BoundingBox * const parentBoxT) :
     BoxRenderData(parentBoxT) {
@@ -23,7 +25,8 @@ ImageRenderData::ImageRenderData(BoundingBox * const parentBoxT) :
 
 void ImageRenderData::updateRelBoundingRect() {
     if(fImage) fRelBoundingRect =
-            QRectF(0, 0, fImage->width(), fImage->height());
+            QRectF(0, 0, fImage->width()/fImageScale,
+                   fImage->height()/fImageScale);
     else fRelBoundingRect = QRectF(0, 0, 0, 0);
 }
 
@@ -38,6 +41,7 @@ void ImageRenderData::setupDirectDraw() {
     updateGlobalRect();
     fRenderTransform.reset();
     fRenderTransform.translate(fRelBoundingRect.x(), fRelBoundingRect.y());
+    fRenderTransform.scale(1/fImageScale, 1/fImageScale);
     fRenderTransform *= fScaledTransform;
     fRenderTransform.translate(-fGlobalRect.x(), -fGlobalRect.y());
     fUseRenderTransform = true;
@@ -49,7 +53,12 @@ void ImageRenderData::setupDirectDraw() {
 void ImageRenderData::drawSk(SkCanvas * const canvas) {
     const float x = static_cast<float>(fRelBoundingRect.x());
     const float y = static_cast<float>(fRelBoundingRect.y());
-    if(fFilterQuality > kNone_SkFilterQuality) {
+    if(fImage && !isOne4Dec(fImageScale)) {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setFilterQuality(qMax(fFilterQuality, kLow_SkFilterQuality));
+        canvas->drawImageRect(fImage, toSkRect(fRelBoundingRect), &paint);
+    } else if(fFilterQuality > kNone_SkFilterQuality) {
         SkPaint paint;
         paint.setAntiAlias(true);
         paint.setFilterQuality(fFilterQuality);
@@ -28,6 +28,8 @@ struct CORE_EXPORT ImageRenderData : public BoxRenderData {
     void setupRenderData() final;
 
     sk_sp<SkImage> fImage;
+    //! @brief Image pixels per box pixel, below one for proxy frames.
+    qreal fImageScale = 1;
 private:
     void setupDirectDraw();
 
@@ -41,14 +41,17 @@ ImageSequenceBox::ImageSequenceBox() :
 
 void ImageSequenceBox::fileHandlerConnector(ConnContext &conn,
                                             ImageSequenceFileHandler *obj) {
-    Q_UNUSED(conn)
-    Q_UNUSED(obj)
+    if(!obj) return;
+    const auto proxy = obj->getProxy();
+    conn << connect(proxy, &ProxyMedia::changed,
+                    this, [this, proxy]() { setProxyMedia(proxy); });
 }
 
 void ImageSequenceBox::fileHandlerAfterAssigned(ImageSequenceFileHandler *obj) {
     qsptr<ImageSequenceCacheHandler> frameHandler;
     if(obj) frameHandler = enve::make_shared<ImageSequenceCacheHandler>(obj);
     setAnimationFramesHandler(frameHandler);
+    setProxyMedia(obj ? obj->getProxy() : nullptr);
     animationDataChanged();
 }
 
@@ -62,6 +65,10 @@ void ImageSequenceBox::changeSourceFile() {
     if(!dir.isEmpty()) setFolderPath(dir);
 }
 
+void ImageSequenceBox::createProxy() {
+    if(mFileHandler) mFileHandler->createProxy();
+}
+
 void ImageSequenceBox::writeBoundingBox(eWriteStream& dst) const {
     AnimationBox::writeBoundingBox(dst);
     dst.writeFilePath(mFileHandler->path());
@@ -30,6 +30,7 @@ public:
     void setFolderPath(const QString &folderPath);
 
     void changeSourceFile();
+    void createProxy();
 
     void writeBoundingBox(eWriteStream& dst) const;
     void readBoundingBox(eReadStream& src);
@@ -16,12 +16,98 @@
 
 #include "layerboxrenderdata.h"
 #include "skia/skqtconversions.h"
+#include "containerbox.h"
+#include "simplemath.h"
+#include "skia/pixelbufferpool.h"
+
+ContainerDrawState::Child::Child(const ChildRenderData& child) :
+    fOrigin(child->origin()),
+    fOpacity(child->fOpacity),
+    fBlendMode(child->fBlendMode),
+    fAntiAlias(child->fAntiAlias),
+    fUseRenderTransform(child->fUseRenderTransform),
+    fRenderTransform(child->fRenderTransform),
+    fClipOps(child.fClip.fClipOps) {
+    const auto& img = child->fRenderedImage;
+    if(!img || isZero4Dec(fOpacity)) return;
+    fRect = QRect(child->fGlobalRect.topLeft(),
+                  QSize(img->width(), img->height()));
+    if(fUseRenderTransform) {
+        // filtering can touch the neighbouring pixels
+        fRect = fRenderTransform.mapRect(fRect).adjusted(-1, -1, 1, 1);
+    }
+}
+
+bool ContainerDrawState::Child::operator==(const Child& other) const {
+    const auto origin = fOrigin.get();
+    return origin && origin == other.fOrigin.get() &&
+           fRect == other.fRect &&
+           isZero4Dec(fOpacity - other.fOpacity) &&
+           fBlendMode == other.fBlendMode &&
+           fAntiAlias == other.fAntiAlias &&
+           fUseRenderTransform == other.fUseRenderTransform &&
+           fRenderTransform == other.fRenderTransform &&
+           fClipOps == other.fClipOps;
+}
+
+bool ContainerDrawState::Child::clearsOutside() const {
+    return fBlendMode == SkBlendMode::kDstIn ||
+           fBlendMode == SkBlendMode::kSrcIn ||
+           fBlendMode == SkBlendMode::kDstATop ||
+           fBlendMode == SkBlendMode::kModulate ||
+           fBlendMode == SkBlendMode::kSrcOut;
+}
+
+int ContainerDrawStateCache::getByteCount() {
+    if(!mState || !mState->fComposite) return 0;
+    SkPixmap pixmap;
+    if(!mState->fComposite->peekPixels(&pixmap)) return 0;
+    return static_cast<int>(PixelBufferPool::sCapacity(
+                                pixmap.computeByteSize()));
+}
+
+bool ContainerDrawState::damageSince(const ContainerDrawState& prev,
+                                     QRegion& damage) const {
+    if(!prev.fComposite) return false;
+    if(prev.fGlobalRect != fGlobalRect) return false;
+    if(prev.fResolutionScale != fResolutionScale) return false;
+    if(prev.fEraseColor != fEraseColor) return false;
+    if(prev.fChildren.count() != fChildren.count()) return false;
+    for(int i = 0; i < fChildren.count(); i++) {
+        const auto& child = fChildren.at(i);
+        const auto& prevChild = prev.fChildren.at(i);
+        if(child == prevChild) continue;
+        if(child.clearsOutside() || prevChild.clearsOutside()) return false;
+        damage += child.fRect;
+        damage += prevChild.fRect;
+    }
+    damage &= fGlobalRect;
+    return true;
+}
+
+QAtomicInteger<qint64> ContainerBoxRenderData::sFramePixelsComposited = 0;
 
 ContainerBoxRenderData::ContainerBoxRenderData(BoundingBox * const parentBox) :
     BoxRenderData(parentBox) {
     mDelayDataSet = true;
 }
 
+qint64 ContainerBoxRenderData::totalProcessingTimeUs() const {
+    qint64 result = processingTimeUs();
+    for(const auto &child : fChildrenRenderData) {
+        result += child->totalProcessingTimeUs();
+    }
+    return result;
+}
+
+qint64 ContainerBoxRenderData::totalPixelsComposited() const {
+    qint64 result = mPixelsComposited;
+    for(const auto &child : fChildrenRenderData) {
+        result += child->totalPixelsComposited();
+    }
+    return result;
+}
+
 void ContainerBoxRenderData::transformRenderCanvas(SkCanvas &canvas) const {
     canvas.translate(toSkScalar(-fGlobalRect.x()),
                      toSkScalar(-fGlobalRect.y()));
@@ -64,6 +150,62 @@ void ContainerBoxRenderData::updateRelBoundingRect() {
     }
 }
 
+void ContainerBoxRenderData::beforeRasterize() {
+    const auto state = std::make_shared<ContainerDrawState>();
+    state->fGlobalRect = fGlobalRect;
+    state->fResolutionScale = fResolutionScale;
+    state->fEraseColor = eraseColor();
+    for(const auto &child : fChildrenRenderData) {
+        state->fChildren << ContainerDrawState::Child(child);
+    }
+    // a composite modified by raster effects is no base for the next one
+    if(!hasEffects()) mDrawState = state;
+    const auto prevState = std::move(fPrevDrawState);
+
+    mDamageBase.reset();
+    mDamage.reset();
+    QRegion damage;
+    if(!prevState || !state->damageSince(*prevState, damage)) {
+        mPixelsComposited = qint64(fGlobalRect.width())*fGlobalRect.height();
+        return;
+    }
+    mDamageBase = prevState->fComposite;
+    mPixelsComposited = 0;
+    // in bitmap coordinates, so each tile clips with its own translation
+    const QPoint origin = fGlobalRect.topLeft();
+    for(const QRect& rect : damage) {
+        mPixelsComposited += qint64(rect.width())*rect.height();
+        mDamage.addRect(toSkRect(rect.translated(-origin)));
+    }
+}
+
+void ContainerBoxRenderData::rasterize(SkCanvas& canvas) {
+    if(!mDamageBase) return BoxRenderData::rasterize(canvas);
+
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    canvas.drawImage(mDamageBase, 0, 0, &paint);
+
+    if(mDamage.isEmpty()) return;
+    canvas.clipPath(mDamage, false);
+    canvas.clear(eraseColor());
+    BoxRenderData::rasterize(canvas);
+}
+
+void ContainerBoxRenderData::afterProcessing() {
+    const auto box = enve_cast<ContainerBox*>(fParentBox.data());
+    if(box && fParentIsTarget && mDrawState &&
+       fRenderedImage && !fRenderedImage->isTextureBacked()) {
+        mDrawState->fComposite = fRenderedImage;
+        const auto cache = enve::make_shared<ContainerDrawStateCache>(mDrawState);
+        cache->setCost(totalProcessingTimeUs()/1000.);
+        box->setLastDrawState(cache);
+    }
+    mDrawState.reset();
+    mDamageBase.reset();
+    BoxRenderData::afterProcessing();
+}
+
 void ContainerBoxRenderData::drawSk(SkCanvas * const canvas) {
     for(const auto &child : fChildrenRenderData) {
         canvas->save();
@@ -17,6 +17,10 @@
 #ifndef CONTAINERBOXRENDERDATA_H
 #define CONTAINERBOXRENDERDATA_H
 #include "boxrenderdata.h"
+#include "CacheHandlers/cachecontainer.h"
+
+#include <QRegion>
+#include <QAtomicInteger>
 
 struct CORE_EXPORT PathClipOp {
     SkPath fClipPath;
@@ -26,6 +30,12 @@ struct CORE_EXPORT PathClipOp {
     void clip(SkCanvas * const canvas) const {
         canvas->clipPath(fClipPath, fClipPathOp, fClipPathAA);
     }
+
+    bool operator==(const PathClipOp& other) const {
+        return fClipPathOp == other.fClipPathOp &&
+               fClipPathAA == other.fClipPathAA &&
+               fClipPath == other.fClipPath;
+    }
 };
 
 struct CORE_EXPORT PathClip {
@@ -52,16 +62,85 @@ struct CORE_EXPORT ChildRenderData {
     PathClip fClip;
 };
 
+//! @brief What a container composite was drawn from,
+//! compared against the next render to find the damaged area.
+struct CORE_EXPORT ContainerDrawState {
+    struct Child {
+        Child(const ChildRenderData& child);
+
+        bool operator==(const Child& other) const;
+        bool operator!=(const Child& other) const
+        { return !(*this == other); }
+
+        //! @brief Blend modes that clear the parent outside the child.
+        bool clearsOutside() const;
+
+        stdptr<BoxRenderData> fOrigin;
+        QRect fRect;
+        qreal fOpacity;
+        SkBlendMode fBlendMode;
+        bool fAntiAlias;
+        bool fUseRenderTransform;
+        QMatrix fRenderTransform;
+        QList<PathClipOp> fClipOps;
+    };
+
+    //! @brief Returns false if everything has to be redrawn.
+    bool damageSince(const ContainerDrawState& prev, QRegion& damage) const;
+
+    QRect fGlobalRect;
+    QMatrix fResolutionScale;
+    SkColor fEraseColor;
+    QList<Child> fChildren;
+    sk_sp<SkImage> fComposite;
+};
+
+//! @brief Keeps the last ContainerDrawState of a container box,
+//! so its composite is accounted and freed with the other caches.
+class CORE_EXPORT ContainerDrawStateCache : public CacheContainer {
+    e_OBJECT
+protected:
+    ContainerDrawStateCache(const stdsptr<ContainerDrawState>& state) :
+        mState(state) {}
+public:
+    int getByteCount();
+
+    const stdsptr<ContainerDrawState>& state() const { return mState; }
+protected:
+    void noDataLeft_k() { mState.reset(); }
+private:
+    stdsptr<ContainerDrawState> mState;
+};
+
 struct CORE_EXPORT ContainerBoxRenderData : public BoxRenderData {
     e_OBJECT
 public:
     ContainerBoxRenderData(BoundingBox * const parentBox);
 
     QList<ChildRenderData> fChildrenRenderData;
+    //! @brief Last finished composite, only the area
+    //! where the children differ from it gets redrawn.
+    stdsptr<ContainerDrawState> fPrevDrawState;
+
+    qint64 totalProcessingTimeUs() const;
+    qint64 totalPixelsComposited() const;
+
+    //! @brief Pixels re-composited for the last finished scene frame.
+    static QAtomicInteger<qint64> sFramePixelsComposited;
 protected:
     void drawSk(SkCanvas * const canvas);
+    void beforeRasterize();
+    void rasterize(SkCanvas& canvas);
+    bool tileable() const { return true; }
     void transformRenderCanvas(SkCanvas& canvas) const final;
     void updateRelBoundingRect();
+    void afterProcessing();
+private:
+    qint64 mPixelsComposited = 0;
+    stdsptr<ContainerDrawState> mDrawState;
+    //! @brief Previous composite to redraw mDamage over, null to redraw all.
+    sk_sp<SkImage> mDamageBase;
+    SkPath mDamage;
 };
 
 #endif // CONTAINERBOXRENDERDATA_H
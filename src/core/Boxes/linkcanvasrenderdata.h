@@ -29,6 +29,9 @@ protected:
     }
 
     void drawSk(SkCanvas * const canvas);
+    // clipping to the canvas draws outside of the children,
+    // always redraw everything
+    void beforeRasterize() {}
 
     void updateRelBoundingRect() {
         if(fClipToCanvas) CanvasRenderData::updateRelBoundingRect();
@@ -38,6 +38,10 @@ protected:
     void drawSk(SkCanvas * const canvas);
     void drawOnParentLayer(SkCanvas * const canvas, SkPaint &paint);
     void copyFrom(BoxRenderData *src);
+    //! @brief Brush strokes replace mBitmap, so only plain ones get tiled.
+    bool tileable() const {
+        return fStrokeSettings.fPaintType != PaintType::BRUSHPAINT;
+    }
 private:
     void setupDirectDraw();
 
@@ -74,6 +74,12 @@ void VideoBox::fileHandlerConnector(ConnContext &conn, VideoFileHandler *obj) {
         conn << connect(newDataHandler, &VideoDataHandler::frameCountUpdated,
                         this, &VideoBox::updateAnimationRange);
     }
+    if(obj) {
+        const auto proxy = obj->getProxy();
+        setProxyMedia(proxy);
+        conn << connect(proxy, &ProxyMedia::changed,
+                        this, [this, proxy]() { setProxyMedia(proxy); });
+    }
 }
 
 void VideoBox::fileHandlerAfterAssigned(VideoFileHandler *obj) {
@@ -85,6 +91,7 @@ void VideoBox::fileHandlerAfterAssigned(VideoFileHandler *obj) {
         cacheHandler = &newDataHandler->getCacheHandler();
     } else cacheHandler = nullptr;
     setAnimationFramesHandler(frameHandler);
+    setProxyMedia(obj ? obj->getProxy() : nullptr);
     getAnimationDurationRect()->setRasterCacheHandler(cacheHandler);
 
     soundDataChanged();
@@ -124,6 +131,10 @@ void VideoBox::changeSourceFile() {
     if(!path.isEmpty()) setFilePath(path);
 }
 
+void VideoBox::createProxy() {
+    if(mFileHandler) mFileHandler->createProxy();
+}
+
 void VideoBox::setStretch(const qreal stretch) {
     AnimationBox::setStretch(stretch);
     mSound->setStretch(stretch);
@@ -32,6 +32,7 @@ protected:
     QDomElement prp_writePropertyXEV_impl(const XevExporter& exp) const;
 public:
     void changeSourceFile();
+    void createProxy();
 
     void writeBoundingBox(eWriteStream& dst) const;
     void readBoundingBox(eReadStream& src);
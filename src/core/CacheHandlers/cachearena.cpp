@@ -0,0 +1,198 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cachearena.h"
+
+#include <QDir>
+
+#include "Private/esettings.h"
+#include "exceptions.h"
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+static const qint64 sBlockSize = 64*1024;
+// the file is grown 64 MB at a time
+static const qint64 sGrowBlocks = 1024;
+
+ArenaSpan::~ArenaSpan() {
+    if(!CacheArena::sAlive) return;
+    CacheArena::sAlive->free(mBlock, mBlocks);
+}
+
+QByteArray ArenaSpan::read() const {
+    QByteArray data;
+    data.resize(static_cast<int>(mSize));
+    auto& arena = CacheArena::sInstance();
+    if(!arena.readAt(mBlock*sBlockSize, data.data(), mSize)) {
+        RuntimeThrow("Could not read from the cache file.");
+    }
+    return data;
+}
+
+CacheArena* CacheArena::sAlive = nullptr;
+
+CacheArena::CacheArena() {
+    sAlive = this;
+}
+
+CacheArena::~CacheArena() {
+    sAlive = nullptr;
+}
+
+CacheArena& CacheArena::sInstance() {
+    static CacheArena instance;
+    return instance;
+}
+
+stdsptr<ArenaSpan> CacheArena::sWrite(const QByteArray& data) {
+    auto& arena = sInstance();
+    const qint64 size = data.size();
+    const qint64 nBlocks = qMax(qint64(1), (size + sBlockSize - 1)/sBlockSize);
+    const qint64 block = arena.allocate(nBlocks);
+    if(block < 0) return nullptr;
+    const auto span = stdsptr<ArenaSpan>(new ArenaSpan(block, nBlocks, size));
+    if(!arena.writeAt(block*sBlockSize, data.data(), size)) return nullptr;
+    return span;
+}
+
+bool CacheArena::sFull() {
+    const qint64 capBlocks = sCapBlocks();
+    if(capBlocks <= 0) return false;
+    return sUsedBytes() >= capBlocks*sBlockSize;
+}
+
+qint64 CacheArena::sCapBlocks() {
+    const int capMB = eSettings::instance().fHddCacheMBCap.fValue;
+    if(capMB <= 0) return 0;
+    return capMB*qint64(1024*1024)/sBlockSize;
+}
+
+qint64 CacheArena::sUsedBytes() {
+    if(!sAlive) return 0;
+    std::lock_guard<std::mutex> lock(sAlive->mMutex);
+    return sAlive->mUsedBlocks*sBlockSize;
+}
+
+bool CacheArena::openFile() {
+    if(mFile.isOpen()) return true;
+    QString folder = eSettings::instance().fHddCacheFolder;
+    if(folder.isEmpty() || !QDir(folder).exists()) folder = QDir::tempPath();
+    mFile.setFileTemplate(QDir(folder).filePath("enve_cache_XXXXXX"));
+    return mFile.open();
+}
+
+qint64 CacheArena::allocate(const qint64 nBlocks) {
+    const qint64 capBlocks = sCapBlocks();
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(capBlocks > 0 && mUsedBlocks + nBlocks > capBlocks) return -1;
+    if(!openFile()) return -1;
+    for(auto it = mFree.begin(); it != mFree.end(); it++) {
+        if(it->second < nBlocks) continue;
+        const qint64 block = it->first;
+        const qint64 rem = it->second - nBlocks;
+        mFree.erase(it);
+        if(rem > 0) mFree[block + nBlocks] = rem;
+        mUsedBlocks += nBlocks;
+        return block;
+    }
+    const qint64 block = mEndBlock;
+    mEndBlock += nBlocks;
+    if(mEndBlock > mFileBlocks) {
+        qint64 newBlocks = mEndBlock + sGrowBlocks;
+        if(capBlocks > 0) newBlocks = qMin(newBlocks, qMax(mEndBlock, capBlocks));
+        if(!mFile.resize(newBlocks*sBlockSize)) {
+            mEndBlock = block;
+            return -1;
+        }
+        mFileBlocks = newBlocks;
+    }
+    mUsedBlocks += nBlocks;
+    return block;
+}
+
+void CacheArena::free(const qint64 block, const qint64 nBlocks) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mUsedBlocks -= nBlocks;
+    qint64 first = block;
+    qint64 count = nBlocks;
+    const auto next = mFree.find(block + nBlocks);
+    if(next != mFree.end()) {
+        count += next->second;
+        mFree.erase(next);
+    }
+    auto prev = mFree.lower_bound(block);
+    if(prev != mFree.begin()) {
+        prev--;
+        if(prev->first + prev->second == block) {
+            first = prev->first;
+            count += prev->second;
+            mFree.erase(prev);
+        }
+    }
+    if(first + count == mEndBlock) {
+        mEndBlock = first;
+        // give the freed tail back to the drive, keeping one growth step
+        if(mFileBlocks - mEndBlock > 2*sGrowBlocks) {
+            const qint64 newBlocks = mEndBlock + sGrowBlocks;
+            std::lock_guard<std::mutex> ioLock(mIOMutex);
+            if(mFile.resize(newBlocks*sBlockSize)) mFileBlocks = newBlocks;
+        }
+    } else mFree[first] = count;
+}
+
+bool CacheArena::writeAt(const qint64 pos, const char* data,
+                         const qint64 len) {
+#ifdef Q_OS_UNIX
+    const int fd = mFile.handle();
+    qint64 done = 0;
+    while(done < len) {
+        const auto res = ::pwrite(fd, data + done,
+                                  static_cast<size_t>(len - done),
+                                  pos + done);
+        if(res < 0 && errno == EINTR) continue;
+        if(res <= 0) return false;
+        done += res;
+    }
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(mIOMutex);
+    if(!mFile.seek(pos)) return false;
+    return mFile.write(data, len) == len;
+#endif
+}
+
+bool CacheArena::readAt(const qint64 pos, char* data, const qint64 len) {
+#ifdef Q_OS_UNIX
+    const int fd = mFile.handle();
+    qint64 done = 0;
+    while(done < len) {
+        const auto res = ::pread(fd, data + done,
+                                 static_cast<size_t>(len - done),
+                                 pos + done);
+        if(res < 0 && errno == EINTR) continue;
+        if(res <= 0) return false;
+        done += res;
+    }
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(mIOMutex);
+    if(!mFile.seek(pos)) return false;
+    return mFile.read(data, len) == len;
+#endif
+}
@@ -0,0 +1,78 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CACHEARENA_H
+#define CACHEARENA_H
+
+#include <QTemporaryFile>
+#include <map>
+#include <mutex>
+
+#include "smartPointers/ememory.h"
+
+//! @brief Run of blocks in the cache arena file,
+//! returned to the arena when the last reference goes away.
+class CORE_EXPORT ArenaSpan {
+    friend class CacheArena;
+    ArenaSpan(const qint64 block, const qint64 nBlocks, const qint64 size) :
+        mBlock(block), mBlocks(nBlocks), mSize(size) {}
+public:
+    ~ArenaSpan();
+
+    qint64 size() const { return mSize; }
+    QByteArray read() const;
+private:
+    const qint64 mBlock;
+    const qint64 mBlocks;
+    const qint64 mSize;
+};
+
+//! @brief Single file in eSettings::fHddCacheFolder holding all the
+//! data moved out of memory, with a first-fit free list of blocks.
+class CORE_EXPORT CacheArena {
+    friend class ArenaSpan;
+    CacheArena();
+public:
+    ~CacheArena();
+
+    static stdsptr<ArenaSpan> sWrite(const QByteArray& data);
+    //! @brief True when fHddCacheMBCap is set and already reached.
+    static bool sFull();
+    static qint64 sUsedBytes();
+private:
+    static CacheArena& sInstance();
+    //! @brief fHddCacheMBCap in blocks, 0 when unlimited.
+    static qint64 sCapBlocks();
+    static CacheArena* sAlive;
+
+    bool openFile();
+    qint64 allocate(const qint64 nBlocks);
+    void free(const qint64 block, const qint64 nBlocks);
+
+    bool writeAt(const qint64 pos, const char* data, const qint64 len);
+    bool readAt(const qint64 pos, char* data, const qint64 len);
+
+    std::mutex mMutex;
+    std::mutex mIOMutex;
+    QTemporaryFile mFile;
+    //! @brief First block and length of each free run
+    std::map<qint64, qint64> mFree;
+    qint64 mFileBlocks = 0;
+    qint64 mEndBlock = 0;
+    qint64 mUsedBlocks = 0;
+};
+
+#endif // CACHEARENA_H
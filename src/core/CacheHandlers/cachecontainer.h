@@ -29,6 +29,15 @@ public:
     ~CacheContainer();
 
     virtual int getByteCount() = 0;
+    //! @brief Containers with higher weight are freed first,
+    //! e.g., when their data is cheap to restore.
+    virtual qreal evictionWeight() const { return 1; }
+    //! @brief False if freeing needs hdd cache space that is not left.
+    virtual bool canFreeRAM() const { return true; }
+
+    //! @brief Time in milliseconds it took to produce the cached data.
+    qreal cost() const { return mCost; }
+    void setCost(const qreal ms) { mCost = ms; }
 protected:
     virtual void noDataLeft_k() = 0;
 private:
@@ -48,6 +57,12 @@ private:
 
     bool mHandledByMemoryHandler = false;
     int mInUse = 0;
+
+    qreal mCost = 1;
+    //! @brief GreedyDual-Size inflation at the time of the last use
+    qreal mInflation = 0;
+    CacheContainer* mPrevCont = nullptr;
+    CacheContainer* mNextCont = nullptr;
 };
 
 #endif // MINIMALCACHECONTAINER_H
@@ -18,9 +18,7 @@
 
 HddCachableCont::HddCachableCont() {}
 
-HddCachableCont::~HddCachableCont() {
-    if(mTmpFile) scheduleDeleteTmpFile();
-}
+HddCachableCont::~HddCachableCont() {}
 
 int HddCachableCont::free_RAM_k() {
     const int bytes = clearMemory();
@@ -29,12 +27,14 @@ int HddCachableCont::free_RAM_k() {
     return bytes;
 }
 
-eTask *HddCachableCont::scheduleDeleteTmpFile() {
-    if(!mTmpFile) return nullptr;
-    const auto updatable = enve::make_shared<TmpDeleter>(mTmpFile);
+qreal HddCachableCont::evictionWeight() const {
+    // data already on the drive only has to be reloaded
+    return mTmpFile ? 2 : 1;
+}
+
+void HddCachableCont::deleteTmpFile() {
+    // blocks go back to the arena once pending loaders are done with them
     mTmpFile.reset();
-    updatable->queTask();
-    return updatable.get();
 }
 
 eTask *HddCachableCont::scheduleSaveToTmpFile() {
@@ -56,11 +56,16 @@ eTask *HddCachableCont::scheduleLoadFromTmpFile() {
     return mTmpLoadTask.get();
 }
 
-void HddCachableCont::setDataSavedToTmpFile(const qsptr<QTemporaryFile> &tmpFile) {
+void HddCachableCont::setDataSavedToTmpFile(const stdsptr<ArenaSpan> &tmpFile) {
     mTmpSaveTask.reset();
     mTmpFile = tmpFile;
 }
 
+void HddCachableCont::setDataSaveFailed() {
+    mTmpSaveTask.reset();
+    if(!mDataInMemory) noDataLeft_k();
+}
+
 void HddCachableCont::afterDataLoadedFromTmpFile() {
     setDataInMemory(true);
     mTmpLoadTask.reset();
@@ -70,7 +75,7 @@ void HddCachableCont::afterDataLoadedFromTmpFile() {
 void HddCachableCont::afterDataReplaced() {
     setDataInMemory(true);
     updateInMemoryManagment();
-    if(mTmpFile) scheduleDeleteTmpFile();
+    deleteTmpFile();
 }
 
 void HddCachableCont::setDataInMemory(const bool dataInMemory) {
@@ -17,7 +17,8 @@
 #ifndef HddCACHABLECONT_H
 #define HddCACHABLECONT_H
 #include "cachecontainer.h"
-#include "tmpdeleter.h"
+#include "cachearena.h"
+#include "Tasks/updatable.h"
 class eTask;
 
 class CORE_EXPORT HddCachableCont : public CacheContainer {
@@ -30,21 +31,23 @@ public:
     ~HddCachableCont();
 
     int free_RAM_k() final;
+    qreal evictionWeight() const;
 
-    eTask* scheduleDeleteTmpFile();
+    void deleteTmpFile();
     eTask* scheduleSaveToTmpFile();
     eTask* scheduleLoadFromTmpFile();
 
-    void setDataSavedToTmpFile(const qsptr<QTemporaryFile> &tmpFile);
+    void setDataSavedToTmpFile(const stdsptr<ArenaSpan> &tmpFile);
+    void setDataSaveFailed();
 
     bool storesDataInMemory() const { return mDataInMemory; }
-    qsptr<QTemporaryFile> getTmpFile() const { return mTmpFile; }
+    stdsptr<ArenaSpan> getTmpFile() const { return mTmpFile; }
 protected:
     void afterDataLoadedFromTmpFile();
     void afterDataReplaced();
     void setDataInMemory(const bool dataInMemory);
 
-    qsptr<QTemporaryFile> mTmpFile;
+    stdsptr<ArenaSpan> mTmpFile;
 private:
     bool mDataInMemory = false;
     stdsptr<eTask> mTmpLoadTask;
@@ -15,7 +15,6 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "imagecachecontainer.h"
-#include "tmpdeleter.h"
 #include "canvas.h"
 #include "skia/skiahelpers.h"
 
@@ -48,14 +48,14 @@ public:
 class CORE_EXPORT ImgSaver : public TmpSaver {
     e_OBJECT
 public:
-    typedef std::function<void(const qsptr<QTemporaryFile>&)> Func;
+    typedef std::function<void(const stdsptr<ArenaSpan>&)> Func;
 protected:
     ImgSaver(ImageCacheContainer* const target,
              const sk_sp<SkImage> &image) :
         TmpSaver(target), mImage(image) {}
 
     void write(eWriteStream& dst) {
-        SkiaHelpers::writeImg(mImage, dst);
+        SkiaHelpers::writeImgCompressed(mImage, dst);
     }
 private:
     const sk_sp<SkImage> mImage;
@@ -68,13 +68,13 @@ public:
 
     const sk_sp<SkImage>& image() const { return mImage; }
 protected:
-    ImgLoader(const qsptr<QTemporaryFile> &file,
+    ImgLoader(const stdsptr<ArenaSpan> &file,
               ImageCacheContainer* const target,
               const Func& finishedFunc) :
         TmpLoader(file, target), mFinishedFunc(finishedFunc) {}
 
     void read(eReadStream& src) {
-        mImage = SkiaHelpers::readImg(src);
+        mImage = SkiaHelpers::readImgCompressed(src);
     }
     void afterProcessing() {
         if(mFinishedFunc) mFinishedFunc(mImage);
@@ -17,6 +17,7 @@
 #include "imagedatahandler.h"
 
 #include "skia/skiahelpers.h"
+#include "skia/pixelbufferpool.h"
 
 ImageDataHandler::ImageDataHandler() {}
 
@@ -35,8 +36,9 @@ int ImageDataHandler::getImageByteCount() const {
     SkPixmap pixmap;
     if(mImage->peekPixels(&pixmap)) {
         const int nCopies = mImageCopies.count();
-        return pixmap.width()*pixmap.height()*
-               pixmap.info().bytesPerPixel()*(1 + nCopies);
+        const size_t bytes = PixelBufferPool::sCapacity(
+                    pixmap.computeByteSize());
+        return static_cast<int>(bytes)*(1 + nCopies);
     }
     return 0;
 }
@@ -17,6 +17,7 @@
 #include "sceneframecontainer.h"
 #include "../Boxes/boxrenderdata.h"
 #include "../canvas.h"
+#include "../Private/esettings.h"
 
 SceneFrameContainer::SceneFrameContainer(
         Canvas * const scene,
@@ -26,12 +27,23 @@ SceneFrameContainer::SceneFrameContainer(
     ImageCacheContainer(data->fRenderedImage, range, parent),
     fBoxState(data->fBoxStateId),
     fResolution(data->fResolution),
-    mScene(scene) {}
+    mScene(scene) {
+    setCost(data->totalProcessingTimeUs()/1000.);
+}
+
+int SceneFrameContainer::clearMemory() {
+    // rendered frames are expensive to reproduce, move them to the drive
+    const auto img = getImage();
+    const bool spill = eSettings::instance().fHddCache && img &&
+                       !img->isTextureBacked() && !CacheArena::sFull();
+    if(spill) scheduleSaveToTmpFile();
+    return ImageCacheContainer::clearMemory();
+}
 
 stdsptr<eHddTask> SceneFrameContainer::createTmpFileDataLoader() {
     const ImgLoader::Func func = [this](sk_sp<SkImage> img) {
         setDataLoadedFromTmpFile(img);
-        if(mScene) mScene->setSceneFrame(ref<SceneFrameContainer>());
+        if(mScene) mScene->sceneFrameLoaded(this);
     };
     return enve::make_shared<ImgLoader>(mTmpFile, this, func);
 }
@@ -30,6 +30,7 @@ public:
     const qreal fResolution;
 protected:
     stdsptr<eHddTask> createTmpFileDataLoader();
+    int clearMemory();
 private:
     const qptr<Canvas> mScene;
 };
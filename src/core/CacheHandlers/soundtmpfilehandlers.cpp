@@ -18,7 +18,7 @@
 #include "soundcachecontainer.h"
 
 SoundContainerTmpFileDataLoader::SoundContainerTmpFileDataLoader(
-        const qsptr<QTemporaryFile> &file,
+        const stdsptr<ArenaSpan> &file,
         SoundCacheContainer *target) :
     TmpLoader(file, target), mTarget(target) {}
 
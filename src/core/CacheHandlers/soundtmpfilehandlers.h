@@ -16,10 +16,8 @@
 
 #ifndef SOUNDTMPFILEHANDLERS_H
 #define SOUNDTMPFILEHANDLERS_H
-#include "tmpdeleter.h"
 #include "soundcachecontainer.h"
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
 #include "skia/skiaincludes.h"
 #include "tmpsaver.h"
 #include "tmploader.h"
@@ -28,7 +26,7 @@ class SoundCacheContainer;
 class CORE_EXPORT SoundContainerTmpFileDataLoader : public TmpLoader {
     e_OBJECT
 public:
-    SoundContainerTmpFileDataLoader(const qsptr<QTemporaryFile> &file,
+    SoundContainerTmpFileDataLoader(const stdsptr<ArenaSpan> &file,
                                     SoundCacheContainer *target);
     void read(eReadStream& src);
     void afterProcessing();
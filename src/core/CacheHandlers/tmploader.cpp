@@ -16,19 +16,22 @@
 
 #include "tmploader.h"
 
-TmpLoader::TmpLoader(const qsptr<QTemporaryFile> &file,
+#include <QBuffer>
+
+QAtomicInteger<qint64> TmpLoader::sBytesRead = 0;
+
+TmpLoader::TmpLoader(const stdsptr<ArenaSpan> &file,
                      HddCachableCont * const target) :
     mTmpFile(file), mTarget(target) {}
 
 void TmpLoader::process() {
     if(!mTmpFile) return;
-    if(mTmpFile->open()) {
-        eReadStream src(mTmpFile.get());
-        read(src);
-        mTmpFile->close();
-    } else {
-        RuntimeThrow("Could not open temporary file for reading.");
-    }
+    QByteArray data = mTmpFile->read();
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    eReadStream src(&buffer);
+    read(src);
+    sBytesRead += data.size();
 }
 
 void TmpLoader::beforeProcessing(const Hardware) {
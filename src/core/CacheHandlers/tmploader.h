@@ -17,19 +17,20 @@
 #ifndef TMPLOADER_H
 #define TMPLOADER_H
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
 #include "hddcachablecont.h"
 
 class CORE_EXPORT TmpLoader : public eHddTask {
 public:
-    TmpLoader(const qsptr<QTemporaryFile> &file,
+    TmpLoader(const stdsptr<ArenaSpan> &file,
               HddCachableCont * const target);
 
     virtual void read(eReadStream& src) = 0;
     void process();
     void beforeProcessing(const Hardware);
+
+    static QAtomicInteger<qint64> sBytesRead;
 private:
-    qsptr<QTemporaryFile> mTmpFile;
+    stdsptr<ArenaSpan> mTmpFile;
     const stdptr<HddCachableCont> mTarget;
 };
 
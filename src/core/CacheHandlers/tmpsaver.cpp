@@ -16,23 +16,31 @@
 
 #include "tmpsaver.h"
 
+#include <QBuffer>
+#include "Private/Tasks/taskscheduler.h"
+
+QAtomicInteger<qint64> TmpSaver::sBytesWritten = 0;
+
 TmpSaver::TmpSaver(HddCachableCont* const target) :
     mTarget(target) {}
 
+void TmpSaver::queTaskNow() {
+    TaskScheduler::instance()->queHddTask(ref<eTask>(), TaskPriority::spill);
+}
+
 void TmpSaver::process() {
-    mTmpFile = qsptr<QTemporaryFile>(new QTemporaryFile());
-    if(mTmpFile->open()) {
-        eWriteStream dst(mTmpFile.get());
-        write(dst);
-        mTmpFile->close();
-        mSavingSuccessful = true;
-    } else {
-        mSavingSuccessful = false;
-    }
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    eWriteStream dst(&buffer);
+    write(dst);
+    buffer.close();
+    mTmpFile = CacheArena::sWrite(buffer.data());
+    mSavingSuccessful = mTmpFile != nullptr;
+    if(mSavingSuccessful) sBytesWritten += mTmpFile->size();
 }
 
 void TmpSaver::afterProcessing() {
     if(!mTarget) return;
-    if(!mSavingSuccessful) return;
-    mTarget->setDataSavedToTmpFile(mTmpFile);
+    if(mSavingSuccessful) mTarget->setDataSavedToTmpFile(mTmpFile);
+    else mTarget->setDataSaveFailed();
 }
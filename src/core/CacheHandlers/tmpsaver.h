@@ -17,7 +17,6 @@
 #ifndef TMPSAVER_H
 #define TMPSAVER_H
 #include "Tasks/updatable.h"
-#include <QTemporaryFile>
 #include "hddcachablecont.h"
 
 class CORE_EXPORT TmpSaver : public eHddTask {
@@ -29,10 +28,14 @@ public:
 
     void process();
     void afterProcessing();
+
+    static QAtomicInteger<qint64> sBytesWritten;
+protected:
+    void queTaskNow();
 private:
     const stdptr<HddCachableCont> mTarget;
     bool mSavingSuccessful = false;
-    qsptr<QTemporaryFile> mTmpFile;
+    stdsptr<ArenaSpan> mTmpFile;
 };
 
 
@@ -35,6 +35,9 @@ public:
     virtual ImageCacheContainer* getFrameAtFrame(const int relFrame) = 0;
     virtual ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) = 0;
     virtual eTask* scheduleFrameLoad(const int frame) = 0;
+    //! @brief Hint that all the frames in range will be needed in order.
+    virtual void scheduleFrameRangeLoad(const FrameRange& range)
+    { Q_UNUSED(range) }
     virtual int getFrameCount() const = 0;
     virtual void reload() = 0;
 
@@ -37,7 +37,8 @@ stdsptr<const AudioStreamsData> AudioStreamsData::sOpen(
 }
 
 void AudioStreamsData::updateSwrContext() {
-    if(mLocked) {
+    std::unique_lock<std::mutex> lock(fMutex, std::try_to_lock);
+    if(!lock.owns_lock()) {
         mUpdateSwrPlanned = true;
         return;
     }
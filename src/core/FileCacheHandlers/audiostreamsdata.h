@@ -16,6 +16,7 @@
 
 #ifndef AUDIOSTREAMSDATA_H
 #define AUDIOSTREAMSDATA_H
+#include <mutex>
 #include "soundreader.h"
 
 struct CORE_EXPORT AudioStreamsData : public QObject {
@@ -33,19 +34,15 @@ protected:
             const QString& path,
             AVFormatContext * const formatContext);
 public:
-    bool lock() {
-        if(mLocked) return false;
-        mLocked = true;
-        return true;
-    }
-
-    bool unlock() {
-        if(!mLocked) return false;
-        mLocked = false;
+    //! @brief Applies a resampler change postponed while a reader
+    //! held fMutex, call from the main thread.
+    void updateSwrContextIfPlanned() {
         if(mUpdateSwrPlanned) updateSwrContext();
-        return true;
     }
 
+    //! @brief Guards the contexts below,
+    //! readers run on any of the hdd threads.
+    std::mutex fMutex;
     QString fPath;
     bool fOpened = false;
     qreal fDurationSec = 0;
@@ -70,7 +67,6 @@ private:
 
     void close();
 
-    bool mLocked = false;
     bool mUpdateSwrPlanned = false;
 };
 
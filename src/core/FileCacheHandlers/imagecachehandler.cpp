@@ -90,6 +90,8 @@ void ImageLoader::process() {
 
 void ImageLoader::afterProcessing() {
     mTargetHandler->replaceImage(mImage);
+    const auto cont = mTargetHandler->getImageContainer();
+    if(cont) cont->setCost(processingTimeUs()/1000.);
 }
 
 void ImageLoader::afterCanceled() {
@@ -70,6 +70,9 @@ class CORE_EXPORT ImageFileDataHandler : public FileDataCacheHandler {
             ImageCacheContainer(img, FrameRange::EMINMAX, nullptr),
             mHandler(handler) {}
 
+        // reloading from the source file is cheaper than re-rendering
+        qreal evictionWeight() const { return 2; }
+
         void noDataLeft_k() {
             ImageCacheContainer::noDataLeft_k();
             if(!mHandler) return;
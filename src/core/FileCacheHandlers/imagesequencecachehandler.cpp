@@ -62,6 +62,14 @@ void ImageSequenceFileHandler::reload() {
         mFrameImageHandlers << handler;
     }
     if(mFrameImageHandlers.isEmpty()) setMissing(true);
+    else mProxy.setSource(path());
+}
+
+void ImageSequenceFileHandler::createProxy() {
+    QStringList frames;
+    for(const auto& handler : mFrameImageHandlers)
+        frames << handler->getFilePath();
+    mProxy.generate(frames, frames.count());
 }
 
 void ImageSequenceFileHandler::replace() {
@@ -18,6 +18,7 @@
 #define IMAGESEQUENCECACHEHANDLER_H
 #include "imagecachehandler.h"
 #include "animationcachehandler.h"
+#include "proxymedia.h"
 
 class CORE_EXPORT ImageSequenceFileHandler : public FileCacheHandler {
 protected:
@@ -29,8 +30,12 @@ public:
     ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame);
     eTask* scheduleFrameLoad(const int frame);
     int getFrameCount() const { return mFrameImageHandlers.count(); }
+
+    ProxyMedia* getProxy() { return &mProxy; }
+    void createProxy();
 private:
     QList<qsptr<ImageFileDataHandler>> mFrameImageHandlers;
+    ProxyMedia mProxy;
 };
 
 class CORE_EXPORT ImageSequenceCacheHandler : public AnimationFrameHandler {
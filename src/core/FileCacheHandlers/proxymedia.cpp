@@ -0,0 +1,384 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "proxymedia.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QCryptographicHash>
+
+#include "videocachehandler.h"
+#include "videostreamsdata.h"
+#include "canvas.h"
+#include "Private/document.h"
+#include "Private/Tasks/complextask.h"
+#include "Private/Tasks/taskscheduler.h"
+
+extern "C" {
+    #include <libavcodec/avcodec.h>
+    #include <libavformat/avformat.h>
+    #include <libswscale/swscale.h>
+    #include <libavutil/pixdesc.h>
+}
+
+const qreal ProxyMedia::sScale = 0.5;
+
+class ProxyEncoder {
+public:
+    ProxyEncoder(const QStringList& srcFiles, const QString& dstPath) :
+        mSrcFiles(srcFiles), mDstPath(dstPath),
+        mTmpPath(dstPath + ".part") {
+        mPacket = av_packet_alloc();
+        mDecoded = av_frame_alloc();
+    }
+
+    ~ProxyEncoder() {
+        closeInput();
+        closeOutput();
+        if(mScaled) av_frame_free(&mScaled);
+        if(mSwsContext) sws_freeContext(mSwsContext);
+        av_frame_free(&mDecoded);
+        av_packet_free(&mPacket);
+        if(!mFinished) QFile::remove(mTmpPath);
+    }
+
+    bool finished() const { return mFinished; }
+    int frameCount() const { return mFrameCount; }
+
+    //! @brief Returns false when there are no more source frames.
+    bool encodeNext();
+    void finish();
+private:
+    void openInput();
+    void closeInput();
+    bool decodeNext();
+
+    void openOutput();
+    void closeOutput();
+    void encode(AVFrame * const frame);
+
+    const QStringList mSrcFiles;
+    const QString mDstPath;
+    const QString mTmpPath;
+
+    bool mFinished = false;
+    int mFileId = 0;
+    int mFrameCount = 0;
+    AVRational mTimeBase{1, 24};
+    //! @brief Source frames are numbered by their pts, as VideoStreamsData
+    //! does, image sequences by their position.
+    bool mSrcPts = false;
+    AVRational mSrcTimeBase{1, 24};
+    int64_t mLastPts = -1;
+
+    AVPacket* mPacket = nullptr;
+    AVFrame* mDecoded = nullptr;
+    AVFrame* mScaled = nullptr;
+    SwsContext* mSwsContext = nullptr;
+
+    AVFormatContext* mInFormat = nullptr;
+    AVCodecContext* mDecoder = nullptr;
+    int mInStreamIndex = -1;
+
+    AVFormatContext* mOutFormat = nullptr;
+    AVCodecContext* mEncoder = nullptr;
+    AVStream* mOutStream = nullptr;
+};
+
+void ProxyEncoder::openInput() {
+    const QString& path = mSrcFiles.at(mFileId);
+    const auto pathStd = path.toStdString();
+    if(avformat_open_input(&mInFormat, pathStd.c_str(), nullptr, nullptr) < 0)
+        RuntimeThrow("Could not open " + path);
+    if(avformat_find_stream_info(mInFormat, nullptr) < 0)
+        RuntimeThrow("Could not retrieve stream info from " + path);
+    mInStreamIndex = av_find_best_stream(mInFormat, AVMEDIA_TYPE_VIDEO,
+                                         -1, -1, nullptr, 0);
+    if(mInStreamIndex < 0) RuntimeThrow("No video stream in " + path);
+    const auto stream = mInFormat->streams[mInStreamIndex];
+    const AVCodec* const codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    if(!codec) RuntimeThrow("Unsupported codec in " + path);
+    mDecoder = avcodec_alloc_context3(codec);
+    if(!mDecoder) RuntimeThrow("Could not allocate decoder context");
+    if(avcodec_parameters_to_context(mDecoder, stream->codecpar) < 0)
+        RuntimeThrow("Could not copy decoder parameters");
+    mDecoder->thread_count = 0;
+    if(avcodec_open2(mDecoder, codec, nullptr) < 0)
+        RuntimeThrow("Could not open decoder for " + path);
+    // image sequences keep the default frame rate
+    if(mSrcFiles.count() == 1) {
+        // the rate VideoStreamsData numbers the source frames with
+        const auto rate = stream->r_frame_rate;
+        if(rate.num > 0 && rate.den > 0) {
+            mTimeBase = av_inv_q(rate);
+            mSrcTimeBase = stream->time_base;
+            mSrcPts = true;
+        }
+    }
+}
+
+void ProxyEncoder::closeInput() {
+    if(mDecoder) avcodec_free_context(&mDecoder);
+    if(mInFormat) avformat_close_input(&mInFormat);
+    mInStreamIndex = -1;
+}
+
+bool ProxyEncoder::decodeNext() {
+    while(true) {
+        if(!mDecoder) {
+            if(mFileId >= mSrcFiles.count()) return false;
+            openInput();
+        }
+        const int recRet = avcodec_receive_frame(mDecoder, mDecoded);
+        if(recRet >= 0) return true;
+        if(recRet == AVERROR_EOF) {
+            closeInput();
+            mFileId++;
+            continue;
+        } else if(recRet != AVERROR(EAGAIN)) {
+            RuntimeThrow("Did not receive frame from the decoder");
+        }
+
+        const int readRet = av_read_frame(mInFormat, mPacket);
+        if(readRet == AVERROR_EOF) {
+            avcodec_send_packet(mDecoder, nullptr);
+        } else if(readRet < 0) {
+            RuntimeThrow("Error retrieving AVPacket");
+        } else if(mPacket->stream_index == mInStreamIndex) {
+            const int sendRet = avcodec_send_packet(mDecoder, mPacket);
+            av_packet_unref(mPacket);
+            if(sendRet < 0) RuntimeThrow("Sending packet to the decoder failed");
+        } else av_packet_unref(mPacket);
+    }
+}
+
+void ProxyEncoder::openOutput() {
+    const auto srcFormat = static_cast<AVPixelFormat>(mDecoded->format);
+    const auto desc = av_pix_fmt_desc_get(srcFormat);
+    const bool alpha = desc && (desc->flags & AV_PIX_FMT_FLAG_ALPHA);
+    // png keeps transparency, mjpeg is faster for opaque sources
+    const auto codecId = alpha ? AV_CODEC_ID_PNG : AV_CODEC_ID_MJPEG;
+    const auto dstFormat = alpha ? AV_PIX_FMT_RGBA : AV_PIX_FMT_YUVJ420P;
+    const int width = qMax(2, 2*qRound(mDecoded->width*ProxyMedia::sScale/2));
+    const int height = qMax(2, 2*qRound(mDecoded->height*ProxyMedia::sScale/2));
+
+    QDir().mkpath(QFileInfo(mDstPath).absolutePath());
+    const auto tmpPathStd = mTmpPath.toStdString();
+    avformat_alloc_output_context2(&mOutFormat, nullptr, "matroska",
+                                   tmpPathStd.c_str());
+    if(!mOutFormat) RuntimeThrow("Could not allocate proxy output context");
+    const AVCodec* const codec = avcodec_find_encoder(codecId);
+    if(!codec) RuntimeThrow("Proxy encoder not found");
+    mOutStream = avformat_new_stream(mOutFormat, nullptr);
+    if(!mOutStream) RuntimeThrow("Could not allocate proxy stream");
+    mEncoder = avcodec_alloc_context3(codec);
+    if(!mEncoder) RuntimeThrow("Could not allocate encoder context");
+    mEncoder->width = width;
+    mEncoder->height = height;
+    mEncoder->pix_fmt = dstFormat;
+    mEncoder->time_base = mTimeBase;
+    mEncoder->framerate = av_inv_q(mTimeBase);
+    mEncoder->thread_count = 0;
+    if(!alpha) {
+        mEncoder->flags |= AV_CODEC_FLAG_QSCALE;
+        mEncoder->global_quality = FF_QP2LAMBDA*3;
+    }
+    if(mOutFormat->oformat->flags & AVFMT_GLOBALHEADER)
+        mEncoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    if(avcodec_open2(mEncoder, codec, nullptr) < 0)
+        RuntimeThrow("Could not open proxy encoder");
+    if(avcodec_parameters_from_context(mOutStream->codecpar, mEncoder) < 0)
+        RuntimeThrow("Could not copy proxy stream parameters");
+    mOutStream->time_base = mTimeBase;
+    mOutStream->avg_frame_rate = av_inv_q(mTimeBase);
+    if(avio_open(&mOutFormat->pb, tmpPathStd.c_str(), AVIO_FLAG_WRITE) < 0)
+        RuntimeThrow("Could not open " + mTmpPath);
+    if(avformat_write_header(mOutFormat, nullptr) < 0)
+        RuntimeThrow("Could not write proxy header");
+
+    mScaled = av_frame_alloc();
+    mScaled->format = dstFormat;
+    mScaled->width = width;
+    mScaled->height = height;
+    if(av_frame_get_buffer(mScaled, 0) < 0)
+        RuntimeThrow("Could not allocate proxy frame");
+}
+
+void ProxyEncoder::closeOutput() {
+    if(mEncoder) avcodec_free_context(&mEncoder);
+    if(mOutFormat) {
+        if(mOutFormat->pb) avio_closep(&mOutFormat->pb);
+        avformat_free_context(mOutFormat);
+        mOutFormat = nullptr;
+    }
+    mOutStream = nullptr;
+}
+
+void ProxyEncoder::encode(AVFrame * const frame) {
+    if(avcodec_send_frame(mEncoder, frame) < 0)
+        RuntimeThrow("Sending frame to the proxy encoder failed");
+    while(true) {
+        const int recRet = avcodec_receive_packet(mEncoder, mPacket);
+        if(recRet == AVERROR(EAGAIN) || recRet == AVERROR_EOF) break;
+        else if(recRet < 0) RuntimeThrow("Did not receive packet from the encoder");
+        av_packet_rescale_ts(mPacket, mEncoder->time_base, mOutStream->time_base);
+        mPacket->stream_index = mOutStream->index;
+        if(av_interleaved_write_frame(mOutFormat, mPacket) < 0)
+            RuntimeThrow("Could not write proxy frame");
+    }
+}
+
+bool ProxyEncoder::encodeNext() {
+    if(!decodeNext()) return false;
+    // proxy frame N has to be source frame N,
+    // so the source frame id becomes the proxy pts in 1/fps units
+    int64_t pts = mFrameCount;
+    if(mSrcPts) {
+        const qreal fps = av_q2d(av_inv_q(mTimeBase));
+        pts = VideoStreamsData::sFrameId(mDecoded->best_effort_timestamp,
+                                         mSrcTimeBase, fps);
+        // frames not addressable in the source are not needed either
+        if(pts <= mLastPts) {
+            av_frame_unref(mDecoded);
+            return true;
+        }
+    }
+    mLastPts = pts;
+    if(!mEncoder) openOutput();
+    if(av_frame_make_writable(mScaled) < 0)
+        RuntimeThrow("Could not make proxy frame writable");
+    mSwsContext = sws_getCachedContext(
+                mSwsContext, mDecoded->width, mDecoded->height,
+                static_cast<AVPixelFormat>(mDecoded->format),
+                mScaled->width, mScaled->height,
+                static_cast<AVPixelFormat>(mScaled->format),
+                SWS_BILINEAR, nullptr, nullptr, nullptr);
+    if(!mSwsContext) RuntimeThrow("Could not initialize proxy conversion");
+    sws_scale(mSwsContext, mDecoded->data, mDecoded->linesize,
+              0, mDecoded->height, mScaled->data, mScaled->linesize);
+    av_frame_unref(mDecoded);
+    mScaled->pts = pts;
+    mFrameCount++;
+    encode(mScaled);
+    return true;
+}
+
+void ProxyEncoder::finish() {
+    if(!mEncoder) RuntimeThrow("No frames to write to the proxy");
+    encode(nullptr);
+    if(av_write_trailer(mOutFormat) < 0)
+        RuntimeThrow("Could not write proxy trailer");
+    closeOutput();
+    QFile::remove(mDstPath);
+    if(!QFile::rename(mTmpPath, mDstPath))
+        RuntimeThrow("Could not move proxy to " + mDstPath);
+    mFinished = true;
+}
+
+class ProxyChunkTask : public eHddTask {
+    e_OBJECT
+protected:
+    ProxyChunkTask(const stdsptr<ProxyEncoder>& encoder) :
+        mEncoder(encoder) {}
+public:
+    void process() {
+        for(int i = 0; i < 8; i++) {
+            if(mEncoder->encodeNext()) continue;
+            mEncoder->finish();
+            break;
+        }
+    }
+private:
+    const stdsptr<ProxyEncoder> mEncoder;
+};
+
+class ProxyTranscodeTask : public ComplexTask {
+public:
+    ProxyTranscodeTask(const stdsptr<ProxyEncoder>& encoder,
+                       const int frameCount, const QString& name) :
+        ComplexTask(qMax(1, frameCount), name), mEncoder(encoder) {}
+
+    void nextStep() {
+        if(done()) return;
+        if(mEncoder->finished()) {
+            finish();
+        } else {
+            setValue(qMin(mEncoder->frameCount(), finishValue() - 1));
+            const auto task = enve::make_shared<ProxyChunkTask>(mEncoder);
+            addTask(task);
+            task->queTask();
+        }
+    }
+private:
+    const stdsptr<ProxyEncoder> mEncoder;
+};
+
+bool ProxyMedia::sUseProxy(const Canvas * const scene) {
+    if(!scene || scene->isRenderingOutput()) return false;
+    return scene->getResolution() <= sScale;
+}
+
+QString ProxyMedia::sProxyPath(const QString& srcPath) {
+    const auto document = Document::sInstance;
+    const QString projectPath = document ? document->fEvFile : QString();
+    QString dir;
+    if(projectPath.isEmpty()) {
+        dir = QDir::tempPath() + "/enve_proxy";
+    } else {
+        const QFileInfo projectInfo(projectPath);
+        dir = projectInfo.absolutePath() + "/" +
+              projectInfo.completeBaseName() + "_proxy";
+    }
+    const QFileInfo info(srcPath);
+    const auto hash = QCryptographicHash::hash(
+                info.absoluteFilePath().toUtf8(), QCryptographicHash::Md5);
+    return dir + "/" + info.fileName() + "_" +
+           QString::fromLatin1(hash.toHex().left(8)) + ".mkv";
+}
+
+void ProxyMedia::setSource(const QString& srcPath) {
+    if(mTask) mTask->cancel();
+    mSrcPath = srcPath;
+    mPath = sProxyPath(srcPath);
+    load();
+}
+
+void ProxyMedia::generate(const QStringList& srcFiles, const int frameCount) {
+    if(mTask || srcFiles.isEmpty()) return;
+    const auto encoder = std::make_shared<ProxyEncoder>(srcFiles, mPath);
+    const QString name = "Proxy " + QFileInfo(mSrcPath).fileName();
+    const auto task = new ProxyTranscodeTask(encoder, frameCount, name);
+    const auto taskSPtr = QSharedPointer<ProxyTranscodeTask>(
+                              task, &QObject::deleteLater);
+    mTask = task;
+    connect(task, &ComplexTask::finishedAll, this, &ProxyMedia::load);
+    TaskScheduler::instance()->addComplexTask(taskSPtr);
+    task->nextStep();
+}
+
+void ProxyMedia::load() {
+    const QFileInfo proxyInfo(mPath);
+    const QFileInfo srcInfo(mSrcPath);
+    const bool upToDate = proxyInfo.exists() &&
+            proxyInfo.lastModified() >= srcInfo.lastModified();
+    if(upToDate) {
+        using VDH = VideoDataHandler;
+        const auto existing = VDH::sGetDataHandler<VDH>(mPath);
+        if(existing) existing->reload();
+        mDataHandler = VDH::sGetCreateDataHandler<VDH>(mPath);
+    } else mDataHandler.reset();
+    emit changed();
+}
@@ -0,0 +1,58 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PROXYMEDIA_H
+#define PROXYMEDIA_H
+#include <QObject>
+#include "smartPointers/ememory.h"
+
+class Canvas;
+class ComplexTask;
+class VideoDataHandler;
+
+//! @brief Low resolution, intra-only copy of a video or an image sequence,
+//! decoded instead of the source while editing at reduced resolution.
+class CORE_EXPORT ProxyMedia : public QObject {
+    Q_OBJECT
+public:
+    //! @brief Size of the proxy frames relative to the source frames.
+    static const qreal sScale;
+
+    //! @brief Proxies are used below sScale canvas resolution,
+    //! never for output rendering.
+    static bool sUseProxy(const Canvas * const scene);
+    static QString sProxyPath(const QString& srcPath);
+
+    //! @brief Picks up a proxy generated earlier for srcPath.
+    void setSource(const QString& srcPath);
+    //! @brief Transcodes srcFiles in the background,
+    //! one file for videos, one file per frame for image sequences.
+    void generate(const QStringList& srcFiles, const int frameCount);
+
+    bool isGenerating() const { return mTask; }
+    VideoDataHandler* dataHandler() const { return mDataHandler.get(); }
+signals:
+    void changed();
+private:
+    void load();
+
+    QString mSrcPath;
+    QString mPath;
+    qsptr<VideoDataHandler> mDataHandler;
+    qptr<ComplexTask> mTask;
+};
+
+#endif // PROXYMEDIA_H
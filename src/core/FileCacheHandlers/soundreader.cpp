@@ -19,20 +19,27 @@
 #include "CacheHandlers/soundcachehandler.h"
 #include "CacheHandlers/soundcachecontainer.h"
 #include "Sound/soundcomposition.h"
+#include "Private/Tasks/taskscheduler.h"
 
-void SoundReader::beforeProcessing(const Hardware) {
-    mOpenedAudio->lock();
+void SoundReader::process() {
+    std::lock_guard<std::mutex> lock(mOpenedAudio->fMutex);
+    readFrame();
 }
 
 void SoundReader::afterProcessing() {
-    mOpenedAudio->unlock();
+    mOpenedAudio->updateSwrContextIfPlanned();
     mCacheHandler->secondReaderFinished(mSecondId, mSamples);
 }
 
 void SoundReader::afterCanceled() {
+    mOpenedAudio->updateSwrContextIfPlanned();
     mCacheHandler->secondReaderCanceled(mSecondId);
 }
 
+void SoundReader::queTaskNow() {
+    TaskScheduler::instance()->queHddTask(ref<eTask>(), TaskPriority::audio);
+}
+
 void seek(const int tryN, const int secondId,
           AVFormatContext * const formatContext,
           const int audioStreamIndex, AVStream * const audioStream,
@@ -42,11 +42,11 @@ protected:
         mSecondId(secondId), mSampleRange(sampleRange),
         mSettings(eSoundSettings::sData()) {}
 
-    void beforeProcessing(const Hardware);
     void afterProcessing();
     void afterCanceled();
+    void queTaskNow();
 public:
-    void process() { readFrame(); }
+    void process();
 protected:
     const stdsptr<Samples>& getSamples() const {
         return mSamples;
@@ -23,6 +23,7 @@
 #include "filesourcescache.h"
 
 #include "videoframeloader.h"
+#include "videorangeloader.h"
 
 VideoFrameHandler::VideoFrameHandler(VideoDataHandler * const cacheHandler) :
     mDataHandler(cacheHandler) {
@@ -38,8 +39,9 @@ ImageCacheContainer* VideoFrameHandler::getFrameAtOrBeforeFrame(const int relFra
 }
 
 void VideoFrameHandler::frameLoaderFinished(const int frame,
-                                            const sk_sp<SkImage>& image) {
-    mDataHandler->frameLoaderFinished(frame, image);
+                                            const sk_sp<SkImage>& image,
+                                            const qint64 timeUs) {
+    mDataHandler->frameLoaderFinished(frame, image, timeUs);
     removeFrameLoader(frame);
 }
 
@@ -110,6 +112,35 @@ eTask* VideoFrameHandler::scheduleFrameLoad(const int frame) {
     return loader;
 }
 
+void VideoFrameHandler::scheduleFrameRangeLoad(const FrameRange& range) {
+    const int last = qMin(range.fMax, getFrameCount() - 1);
+    if(range.fMin < 0 || range.fMin > last) return;
+    // continue after the frames already in flight or cached,
+    // so decoding stays ahead of conversion
+    int first = range.fMin;
+    while(first <= last && (getFrameLoader(first) ||
+                            mDataHandler->getFrameAtFrame(first))) first++;
+    if(first > last) return;
+    // refill in batches rather than a single frame per call,
+    // unless the first frame itself or the end of the file is missing
+    const int minBatch = qMax(1, (last - range.fMin + 1)/4);
+    if(first > range.fMin && last == range.fMax &&
+       last - first + 1 < minBatch) return;
+    FrameRange toLoad{first, first};
+    for(int i = first; i <= last; i++) {
+        if(getFrameLoader(i)) continue;
+        if(mDataHandler->getFrameAtFrame(i)) continue;
+        // waits unqueued for a frame from the range loader
+        const auto loader = enve::make_shared<VideoFrameLoader>(
+                        this, mVideoStreamsData, i);
+        mDataHandler->addFrameLoader(i, loader);
+        toLoad.fMax = i;
+    }
+    const auto rangeLoader = enve::make_shared<VideoRangeLoader>(
+                this, mVideoStreamsData, toLoad);
+    rangeLoader->queTask();
+}
+
 int VideoFrameHandler::getFrameCount() const {
     return mDataHandler->getFrameCount();
 }
@@ -149,6 +180,11 @@ void VideoFileHandler::replace() {
     }
 }
 
+void VideoFileHandler::createProxy() {
+    if(!mDataHandler) return;
+    mProxy.generate({path()}, mDataHandler->getFrameCount());
+}
+
 void VideoDataHandler::afterSourceChanged() {
     for(const auto& handler : mFrameHandlers) {
         handler->afterSourceChanged();
@@ -179,10 +215,14 @@ void VideoDataHandler::removeFrameLoader(const int frame) {
 }
 
 void VideoDataHandler::frameLoaderFinished(const int frame,
-                                           const sk_sp<SkImage> &image) {
+                                           const sk_sp<SkImage> &image,
+                                           const qint64 timeUs) {
     if(image) {
-        mFramesCache.add(enve::make_shared<ImageCacheContainer>(
-                             image, FrameRange{frame, frame}, &mFramesCache));
+        const auto cont = enve::make_shared<ImageCacheContainer>(
+                    image, FrameRange{frame, frame}, &mFramesCache);
+        // decoding and conversion time
+        cont->setCost(timeUs/1000.);
+        mFramesCache.add(cont);
     } else {
         mFrameCount = frame;
         emit frameCountUpdated(mFrameCount);
@@ -240,6 +280,7 @@ void VideoFileHandler::reload() {
     const QString& path = this->path();
     mDataHandler = VideoDataHandler::sGetCreateDataHandler<VideoDataHandler>(path);
     mDataHandler->reload();
+    mProxy.setSource(path);
     if(hasSound(path.toUtf8().data())) {
         mSoundHandler = SoundDataHandler::sGetCreateDataHandler<SoundDataHandler>(path);
         mSoundHandler->reload();
@@ -20,6 +20,7 @@
 #include "videostreamsdata.h"
 #include <set>
 #include "filecachehandler.h"
+#include "proxymedia.h"
 class VideoFrameLoader;
 class VideoFrameHandler;
 
@@ -36,7 +37,8 @@ public:
     void addFrameLoader(const int frameId, const stdsptr<VideoFrameLoader>& loader);
     VideoFrameLoader * getFrameLoader(const int frame) const;
     void removeFrameLoader(const int frame);
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const qint64 timeUs);
     eTask* scheduleFrameHddCacheLoad(const int frame);
     ImageCacheContainer* getFrameAtFrame(const int relFrame) const;
     ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame) const;
@@ -55,18 +57,21 @@ private:
 class CORE_EXPORT VideoFrameHandler : public AnimationFrameHandler {
     e_OBJECT
     friend class VideoFrameLoader;
+    friend class VideoRangeLoader;
 protected:
     VideoFrameHandler(VideoDataHandler* const cacheHandler);
 public:
     ImageCacheContainer* getFrameAtFrame(const int relFrame);
     ImageCacheContainer* getFrameAtOrBeforeFrame(const int relFrame);
     eTask *scheduleFrameLoad(const int frame);
+    void scheduleFrameRangeLoad(const FrameRange& range);
     int getFrameCount() const;
     void reload();
 
     void afterSourceChanged();
 
-    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image);
+    void frameLoaderFinished(const int frame, const sk_sp<SkImage>& image,
+                             const qint64 timeUs);
     void frameLoaderCanceled(const int frameId);
     void frameLoaderFailed(const int frameId);
 
@@ -102,9 +107,13 @@ public:
     SoundDataHandler* getSoundHandler() const {
         return mSoundHandler.get();
     }
+
+    ProxyMedia* getProxy() { return &mProxy; }
+    void createProxy();
 private:
     qsptr<VideoDataHandler> mDataHandler;
     qsptr<SoundDataHandler> mSoundHandler;
+    ProxyMedia mProxy;
 };
 
 #endif // VIDEOCACHEHANDLER_H
@@ -0,0 +1,138 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "videoframeindex.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <algorithm>
+#include "exceptions.h"
+
+#define INDEX_MAGIC "enveVIdx"
+#define INDEX_VERSION 1
+
+int VideoFrameIndex::frameAtPts(const int64_t pts) const {
+    const auto it = std::upper_bound(mFramePts.begin(), mFramePts.end(), pts);
+    return int(it - mFramePts.begin()) - 1;
+}
+
+int VideoFrameIndex::keyFrameAtOrBefore(const int frame) const {
+    const auto it = std::upper_bound(mKeyFrames.begin(), mKeyFrames.end(), frame);
+    if(it == mKeyFrames.begin()) return 0;
+    return *(it - 1);
+}
+
+QString VideoFrameIndex::sCachePath(const QString& filePath,
+                                    const QString& projectPath) {
+    QString dir;
+    if(projectPath.isEmpty()) {
+        dir = QDir::tempPath() + "/enve_index";
+    } else {
+        const QFileInfo projectInfo(projectPath);
+        dir = projectInfo.absolutePath() + "/" +
+              projectInfo.completeBaseName() + "_index";
+    }
+    const QFileInfo info(filePath);
+    const auto hash = QCryptographicHash::hash(
+                info.absoluteFilePath().toUtf8(), QCryptographicHash::Md5);
+    return dir + "/" + info.fileName() + "_" +
+           QString::fromLatin1(hash.toHex().left(8)) + ".vidx";
+}
+
+void VideoFrameIndex::loadOrBuild(const QString& filePath,
+                                  const QString& cachePath,
+                                  const int videoStreamIndex) {
+    if(load(filePath, cachePath)) return;
+    build(filePath, videoStreamIndex);
+    if(isValid()) save(filePath, cachePath);
+}
+
+bool VideoFrameIndex::load(const QString& filePath, const QString& cachePath) {
+    QFile file(cachePath);
+    if(!file.open(QIODevice::ReadOnly)) return false;
+    QDataStream stream(&file);
+    QByteArray magic;
+    qint32 version;
+    qint64 size;
+    QDateTime modified;
+    stream >> magic >> version >> size >> modified;
+    const QFileInfo info(filePath);
+    if(magic != INDEX_MAGIC || version != INDEX_VERSION ||
+       size != info.size() || modified != info.lastModified()) return false;
+    QVector<qint64> framePts;
+    stream >> framePts >> mKeyFrames;
+    if(stream.status() != QDataStream::Ok) {
+        mKeyFrames.clear();
+        return false;
+    }
+    mFramePts.clear();
+    mFramePts.reserve(framePts.count());
+    for(const qint64 pts : framePts) mFramePts << pts;
+    return isValid();
+}
+
+void VideoFrameIndex::save(const QString& filePath,
+                           const QString& cachePath) const {
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+    QFile file(cachePath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return;
+    QVector<qint64> framePts;
+    framePts.reserve(mFramePts.count());
+    for(const int64_t pts : mFramePts) framePts << pts;
+    const QFileInfo info(filePath);
+    QDataStream stream(&file);
+    stream << QByteArray(INDEX_MAGIC) << qint32(INDEX_VERSION) <<
+              qint64(info.size()) << info.lastModified() <<
+              framePts << mKeyFrames;
+}
+
+void VideoFrameIndex::build(const QString& filePath,
+                            const int videoStreamIndex) {
+    mFramePts.clear();
+    mKeyFrames.clear();
+    AVFormatContext* formatContext = nullptr;
+    const auto path = filePath.toUtf8();
+    if(avformat_open_input(&formatContext, path.constData(),
+                           nullptr, nullptr) != 0) return;
+    AVPacket* packet = av_packet_alloc();
+    // demux only, packets are not decoded
+    QVector<std::pair<int64_t, bool>> frames;
+    bool valid = packet != nullptr;
+    while(valid && av_read_frame(formatContext, packet) >= 0) {
+        if(packet->stream_index == videoStreamIndex) {
+            const int64_t pts = packet->pts;
+            if(pts == AV_NOPTS_VALUE) valid = false;
+            else frames.append({pts, (packet->flags & AV_PKT_FLAG_KEY) != 0});
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&formatContext);
+    if(!valid || frames.isEmpty()) return;
+
+    std::sort(frames.begin(), frames.end());
+    mFramePts.reserve(frames.count());
+    for(const auto& frame : frames) {
+        if(!mFramePts.isEmpty() && mFramePts.last() == frame.first) continue;
+        if(frame.second) mKeyFrames << mFramePts.count();
+        mFramePts << frame.first;
+    }
+    if(mKeyFrames.isEmpty()) mFramePts.clear();
+}
@@ -0,0 +1,51 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef VIDEOFRAMEINDEX_H
+#define VIDEOFRAMEINDEX_H
+#include <QVector>
+#include <QString>
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+//! @brief Presentation timestamps of all video frames and their keyframes,
+//! so frame loaders can seek exactly to the keyframe a frame depends on.
+class VideoFrameIndex {
+public:
+    bool isValid() const { return !mFramePts.isEmpty(); }
+    int frameCount() const { return mFramePts.count(); }
+
+    int64_t framePts(const int frame) const { return mFramePts.at(frame); }
+    //! @brief Frame presenting at pts, or the last one before it.
+    int frameAtPts(const int64_t pts) const;
+    int keyFrameAtOrBefore(const int frame) const;
+
+    //! @brief Loads the index cached in cachePath or builds it from the file.
+    void loadOrBuild(const QString& filePath, const QString& cachePath,
+                     const int videoStreamIndex);
+    static QString sCachePath(const QString& filePath,
+                              const QString& projectPath);
+private:
+    bool load(const QString& filePath, const QString& cachePath);
+    void save(const QString& filePath, const QString& cachePath) const;
+    void build(const QString& filePath, const int videoStreamIndex);
+
+    QVector<int64_t> mFramePts;
+    QVector<int> mKeyFrames;
+};
+
+#endif // VIDEOFRAMEINDEX_H
@@ -18,6 +18,7 @@
 #include "videocachehandler.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/taskexecutor.h"
+#include "skia/pixelbufferpool.h"
 
 VideoFrameLoader::VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                                    const stdsptr<VideoStreamsData> &openedVideo,
@@ -44,7 +45,8 @@ void VideoFrameLoader::convertFrame() {
     const auto info = SkiaHelpers::getPremulRGBAInfo(
                 mFrameToConvert->width, mFrameToConvert->height);
     SkBitmap bitmap;
-    bitmap.allocPixels(info);
+    // sws_scale writes all the rows
+    PixelBufferPool::sAllocPixels(bitmap, info, false);
 
     SkPixmap pixmap;
     bitmap.peekPixels(&pixmap);
@@ -64,17 +66,6 @@ void VideoFrameLoader::convertFrame() {
     cleanUp();
 }
 
-int frameId(AVFrame * const decodedFrame,
-            AVStream * const videoStream,
-            const qreal fps) {
-    int64_t pts = decodedFrame->best_effort_timestamp;
-    pts = av_rescale_q(pts, videoStream->time_base, {1, AV_TIME_BASE});
-    const qreal frameApprox = pts/1000000.*fps;
-    const int frameRound = qRound(frameApprox);
-    if(frameRound - frameApprox > 0.4) return frameRound - 1;
-    return frameRound;
-}
-
 void seek(const int tryN, const int frameId, const qreal fps,
           AVFormatContext * const formatContext,
           const int videoStreamIndex, AVStream * const videoStream,
@@ -102,6 +93,36 @@ void seek(const int tryN, const int frameId, const qreal fps,
 void VideoFrameLoader::readFrame() {
     if(!mOpenedVideo->fOpened)
         RuntimeThrow("Cannot read frame from closed VideoStream");
+    std::lock_guard<std::mutex> lock(mOpenedVideo->fMutex);
+    if(mOpenedVideo->indexReady()) readFrameIndexed();
+    else readFrameSeeking();
+}
+
+void VideoFrameLoader::readFrameIndexed() {
+    if(mFrameId < 0) return;
+    const auto codecContext = mOpenedVideo->fCodecContext;
+    mOpenedVideo->decodeIndexed(mFrameId, [&](const int currFrame,
+                                              AVFrame*& decoded) {
+        if(currFrame > mFrameId && !mExcessFrames.isEmpty()) {
+            // no frame presents at mFrameId, keep showing the previous one
+            setFrameToConvert(mExcessFrames.takeLast().second, codecContext);
+            return true;
+        } else if(currFrame >= mFrameId) {
+            if(currFrame > mFrameId)
+                qDebug() << "frame " + QString::number(currFrame) +
+                            " instead of " + QString::number(mFrameId);
+            setFrameToConvert(decoded, codecContext);
+            decoded = nullptr;
+            return true;
+        } else if(mFrameId - currFrame < 20) {
+            mExcessFrames.append({currFrame, decoded});
+            decoded = nullptr;
+        }
+        return false;
+    });
+}
+
+void VideoFrameLoader::readFrameSeeking() {
     const auto formatContext = mOpenedVideo->fFormatContext;
     const auto videoStreamIndex = mOpenedVideo->fVideoStreamIndex;
     const auto videoStream = mOpenedVideo->fVideoStream;
@@ -141,7 +162,8 @@ void VideoFrameLoader::readFrame() {
             continue;
         }
 
-        const int currFrame = frameId(decodedFrame, videoStream, fps);
+        const int currFrame = mOpenedVideo->frameId(
+                    decodedFrame->best_effort_timestamp);
         const bool usePrevious = mFrameId > lastFrameTmp &&
                                  currFrame > mFrameId &&
                                  !mExcessFrames.isEmpty();
@@ -186,7 +208,8 @@ void VideoFrameLoader::readFrame() {
 
 void VideoFrameLoader::afterProcessing() {
     if(!mCacheHandler) return;
-    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame);
+    mCacheHandler->frameLoaderFinished(mFrameId, mLoadedFrame,
+                                       processingTimeUs());
     for(auto& excess : mExcessFrames) {
         if(mCacheHandler->getFrameAtFrame(excess.first)) {
             av_frame_unref(excess.second);
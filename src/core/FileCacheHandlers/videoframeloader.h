@@ -31,6 +31,7 @@ extern "C" {
 struct VideoStreamsData;
 class CORE_EXPORT VideoFrameLoader : public eHddTask {
     e_OBJECT
+    friend class VideoRangeLoader;
 protected:
     VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                      const stdsptr<VideoStreamsData>& openedVideo,
@@ -53,6 +54,8 @@ private:
     void cleanUp();
     void setupSwsContext(AVCodecContext * const codecContext);
     void readFrame();
+    void readFrameIndexed();
+    void readFrameSeeking();
     void setFrameToConvert(AVFrame * const frame,
                            AVCodecContext * const codecContext);
     void convertFrame();
@@ -0,0 +1,108 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "videorangeloader.h"
+#include "videocachehandler.h"
+#include "videoframeloader.h"
+#include "Private/Tasks/taskscheduler.h"
+
+#include <QElapsedTimer>
+
+VideoRangeLoader::VideoRangeLoader(VideoFrameHandler * const cacheHandler,
+                                   const stdsptr<VideoStreamsData> &openedVideo,
+                                   const FrameRange& range) :
+    mCacheHandler(cacheHandler), mOpenedVideo(openedVideo),
+    mRange(range) {}
+
+VideoRangeLoader::~VideoRangeLoader() {
+    for(auto& decoded : mDecoded) {
+        av_frame_unref(decoded.fFrame);
+        av_frame_free(&decoded.fFrame);
+    }
+}
+
+void VideoRangeLoader::process() {
+    if(!mOpenedVideo->fOpened)
+        RuntimeThrow("Cannot read frames from closed VideoStream");
+    std::lock_guard<std::mutex> lock(mOpenedVideo->fMutex);
+    // without the index frames are left to the individual loaders
+    if(!mOpenedVideo->indexReady()) return;
+    const int last = mRange.fMax;
+    if(mRange.fMin < 0 || mRange.fMin > last) return;
+    QElapsedTimer timer;
+    timer.start();
+    mOpenedVideo->decodeIndexed(mRange.fMin, [&](const int currFrame,
+                                                 AVFrame*& decoded) {
+        if(currFrame > last) return true;
+        // time since the previous frame, the first one includes the seek
+        const qint64 decodeUs = timer.nsecsElapsed()/1000;
+        timer.restart();
+        frameDecoded(currFrame, decoded, decodeUs);
+        decoded = nullptr;
+        return currFrame == last;
+    });
+}
+
+void VideoRangeLoader::frameDecoded(const int frameId, AVFrame * const frame,
+                                    const qint64 decodeUs) {
+    {
+        std::lock_guard<std::mutex> lock(mDecodedMutex);
+        mDecoded.append({frameId, frame, decodeUs});
+    }
+    const auto self = ref<VideoRangeLoader>();
+    QMetaObject::invokeMethod(TaskScheduler::instance(), [self]() {
+        self->publishDecoded();
+    }, Qt::QueuedConnection);
+}
+
+void VideoRangeLoader::publishDecoded() {
+    QList<Decoded> decoded;
+    {
+        std::lock_guard<std::mutex> lock(mDecodedMutex);
+        std::swap(decoded, mDecoded);
+    }
+    for(auto& frame : decoded) {
+        const auto loader = mCacheHandler ?
+                    mCacheHandler->getFrameLoader(frame.fFrameId) : nullptr;
+        if(loader && loader->getState() == eTaskState::created) {
+            loader->setFrameToConvert(frame.fFrame,
+                                      mOpenedVideo->fCodecContext);
+            loader->addProcessingTime(frame.fDecodeUs);
+            loader->queTask();
+        } else {
+            av_frame_unref(frame.fFrame);
+            av_frame_free(&frame.fFrame);
+        }
+    }
+}
+
+void VideoRangeLoader::releaseWaiting() {
+    publishDecoded();
+    if(!mCacheHandler) return;
+    for(int i = mRange.fMin; i <= mRange.fMax; i++) {
+        const auto loader = mCacheHandler->getFrameLoader(i);
+        if(loader && loader->getState() == eTaskState::created)
+            loader->queTask();
+    }
+}
+
+void VideoRangeLoader::afterProcessing() {
+    releaseWaiting();
+}
+
+void VideoRangeLoader::afterCanceled() {
+    releaseWaiting();
+}
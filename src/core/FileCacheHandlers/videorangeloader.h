@@ -0,0 +1,63 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef VIDEORANGELOADER_H
+#define VIDEORANGELOADER_H
+#include "Tasks/updatable.h"
+#include "framerange.h"
+#include "videostreamsdata.h"
+#include <mutex>
+
+class VideoFrameHandler;
+
+//! @brief Decodes a whole frame range in a single pass.
+//! Decoded frames are handed over to the frame loaders waiting for them,
+//! which convert them to RGBA on the cpu threads while decoding continues.
+class CORE_EXPORT VideoRangeLoader : public eHddTask {
+    e_OBJECT
+protected:
+    VideoRangeLoader(VideoFrameHandler * const cacheHandler,
+                     const stdsptr<VideoStreamsData>& openedVideo,
+                     const FrameRange& range);
+public:
+    ~VideoRangeLoader();
+
+    void process();
+protected:
+    void afterProcessing();
+    void afterCanceled();
+private:
+    //! @brief decodeUs is the frame's share of the decoding time.
+    void frameDecoded(const int frameId, AVFrame * const frame,
+                      const qint64 decodeUs);
+    void publishDecoded();
+    void releaseWaiting();
+
+    const qptr<VideoFrameHandler> mCacheHandler;
+    const stdsptr<VideoStreamsData> mOpenedVideo;
+    const FrameRange mRange;
+
+    struct Decoded {
+        int fFrameId;
+        AVFrame* fFrame;
+        qint64 fDecodeUs;
+    };
+
+    std::mutex mDecodedMutex;
+    QList<Decoded> mDecoded;
+};
+
+#endif // VIDEORANGELOADER_H
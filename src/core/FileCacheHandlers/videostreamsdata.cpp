@@ -15,18 +15,63 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "videostreamsdata.h"
+#include "Private/document.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "Tasks/updatable.h"
+#include <cmath>
 
 stdsptr<VideoStreamsData> VideoStreamsData::sOpen(const QString &path) {
     const auto result = std::shared_ptr<VideoStreamsData>(
                 new VideoStreamsData, VideoStreamsData::sDestroy);
     result->open(path);
+    sBuildIndex(result);
     return result;
 }
 
+//! @brief Demuxes the whole file, kept on the spill executor
+//! so neither render workers nor frame reads wait for it.
+class VideoIndexBuilder : public eHddTask {
+    e_OBJECT
+protected:
+    VideoIndexBuilder(const stdsptr<VideoStreamsData>& data) :
+        mData(data), mPath(data->fPath), mIndexPath(data->fIndexPath),
+        mStreamIndex(data->fVideoStreamIndex) {}
+
+    void queTaskNow() {
+        TaskScheduler::instance()->queHddTask(ref<eTask>(),
+                                              TaskPriority::spill);
+    }
+public:
+    void process() {
+        mIndex.loadOrBuild(mPath, mIndexPath, mStreamIndex);
+    }
+protected:
+    void afterProcessing() {
+        const auto data = mData.lock();
+        if(!data) return;
+        // loaders do not read fIndex before fIndexReady is set
+        data->fIndex = mIndex;
+        data->fIndexReady = true;
+    }
+private:
+    const std::weak_ptr<VideoStreamsData> mData;
+    const QString mPath;
+    const QString mIndexPath;
+    const int mStreamIndex;
+    VideoFrameIndex mIndex;
+};
+
+void VideoStreamsData::sBuildIndex(const stdsptr<VideoStreamsData>& data) {
+    const auto task = enve::make_shared<VideoIndexBuilder>(data);
+    task->queTask();
+}
 
 void VideoStreamsData::open(const QString &path) {
     try {
         fPath = path;
+        const auto document = Document::sInstance;
+        fIndexPath = VideoFrameIndex::sCachePath(
+                    path, document ? document->fEvFile : QString());
         open();
     } catch(...) {
         fPath.clear();
@@ -34,6 +79,81 @@ void VideoStreamsData::open(const QString &path) {
     }
 }
 
+int VideoStreamsData::sFrameId(const int64_t pts, const AVRational& timeBase,
+                               const qreal fps) {
+    const int64_t ptsUs = av_rescale_q(pts, timeBase, {1, AV_TIME_BASE});
+    const qreal frameApprox = ptsUs/1000000.*fps;
+    const int frameRound = qRound(frameApprox);
+    if(frameRound - frameApprox > 0.4) return frameRound - 1;
+    return frameRound;
+}
+
+void VideoStreamsData::decodeIndexed(const int frame, const DecodeFunc& func) {
+    // frameId maps pts from (frame - 0.4)/fps on to frame,
+    // start a bit earlier so the keyframe is never past the first one
+    const auto startUs = static_cast<int64_t>(
+                std::floor((frame - 0.5)*AV_TIME_BASE/fFps));
+    const int64_t startPts = av_rescale_q(startUs, {1, AV_TIME_BASE},
+                                          fVideoStream->time_base);
+    const int firstEntry = qMin(fIndex.frameCount() - 1,
+                                fIndex.frameAtPts(startPts - 1) + 1);
+    const int64_t keyPts = fIndex.framePts(
+                fIndex.keyFrameAtOrBefore(firstEntry));
+    const int keyFrame = frameId(keyPts);
+    // no keyframe in between, keep decoding forward
+    const bool sequential = fLastFrame >= keyFrame && fLastFrame < frame;
+    const int firstValid = sequential ? fLastFrame + 1 : keyFrame;
+    if(!sequential) {
+        const int seekRet = av_seek_frame(fFormatContext, fVideoStreamIndex,
+                                          keyPts, AVSEEK_FLAG_BACKWARD);
+        if(seekRet < 0) RuntimeThrow("Failed to seek to " + QString::number(frame));
+        avcodec_flush_buffers(fCodecContext);
+    }
+    fLastFrame = -1; // Just in case error occurs
+
+    bool draining = false;
+    while(true) {
+        if(!draining) {
+            const int readRet = av_read_frame(fFormatContext, fPacket);
+            if(readRet == AVERROR_EOF) {
+                draining = true;
+                avcodec_send_packet(fCodecContext, nullptr);
+            } else if(readRet < 0) {
+                RuntimeThrow("Error retrieving AVPacket");
+            } else if(fPacket->stream_index != fVideoStreamIndex) {
+                av_packet_unref(fPacket);
+                continue;
+            } else {
+                const int sendRet = avcodec_send_packet(fCodecContext, fPacket);
+                av_packet_unref(fPacket);
+                if(sendRet < 0) RuntimeThrow("Sending packet to the decoder failed");
+            }
+        }
+
+        const int recRet = avcodec_receive_frame(fCodecContext, fDecodedFrame);
+        if(recRet == AVERROR_EOF) break;
+        else if(recRet == AVERROR(EAGAIN)) {
+            if(draining) break;
+            continue;
+        } else if(recRet < 0) {
+            RuntimeThrow("Did not receive frame from the decoder");
+        }
+
+        const int currFrame = frameId(fDecodedFrame->best_effort_timestamp);
+        if(currFrame < firstValid) {
+            av_frame_unref(fDecodedFrame);
+            continue;
+        }
+        const bool stop = func(currFrame, fDecodedFrame);
+        if(fDecodedFrame) av_frame_unref(fDecodedFrame);
+        else fDecodedFrame = av_frame_alloc();
+        if(stop) {
+            if(!draining) fLastFrame = currFrame;
+            break;
+        }
+    }
+}
+
 void VideoStreamsData::close() {
     fOpened = false;
 
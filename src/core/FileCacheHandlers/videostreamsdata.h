@@ -17,6 +17,10 @@
 #ifndef VIDEOSTREAMSDATA_H
 #define VIDEOSTREAMSDATA_H
 #include "audiostreamsdata.h"
+#include "videoframeindex.h"
+#include <mutex>
+#include <atomic>
+#include <functional>
 
 struct CORE_EXPORT VideoStreamsData {
 private:
@@ -45,10 +49,36 @@ public:
     struct SwsContext * fSwsContext = nullptr;
     int fLastFrame = 0;
 
+    //! @brief Guards the demuxer and decoder used by frame loaders
+    std::mutex fMutex;
+    QString fIndexPath;
+    //! @brief Set once fIndex is built, fIndex is not modified afterwards.
+    std::atomic<bool> fIndexReady{false};
+    VideoFrameIndex fIndex;
+
     stdsptr<const AudioStreamsData> fAudioData;
 
     static stdsptr<VideoStreamsData> sOpen(const QString& path);
+
+    bool indexReady() const { return fIndexReady && fIndex.isValid(); }
+
+    //! @brief Frame presenting at pts, pts*fps rounded as in older versions.
+    int frameId(const int64_t pts) const
+    { return sFrameId(pts, fVideoStream->time_base, fFps); }
+    static int sFrameId(const int64_t pts, const AVRational& timeBase,
+                        const qreal fps);
+
+    using DecodeFunc = std::function<bool(const int frame, AVFrame*& decoded)>;
+    //! @brief Decodes frames starting at frame in presentation order until
+    //! func returns true, seeking only when the decoder cannot stream forward.
+    //! Func takes ownership of a decoded frame by setting it to nullptr.
+    //! Requires indexReady() and fMutex locked.
+    void decodeIndexed(const int frame, const DecodeFunc& func);
 private:
+    //! @brief Loads or builds fIndex in an hdd task, without fMutex,
+    //! loaders seek approximately until it is ready.
+    static void sBuildIndex(const stdsptr<VideoStreamsData>& data);
+
     void open(const QString& path);
     void open();
     void open(const char * const path);
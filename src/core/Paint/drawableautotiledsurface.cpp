@@ -64,14 +64,15 @@ void DrawableAutoTiledSurface::drawOnCanvas(SkCanvas * const canvas,
 }
 
 void DrawableAutoTiledSurface::pixelRectChanged(const QRect &pixRect) {
-    if(mTmpFile) scheduleDeleteTmpFile();
+    deleteTmpFile();
     updateTileRecBitmaps(pixRectToTileRect(pixRect));
 }
 
 void DrawableAutoTiledSurface::write(eWriteStream &dst) {
     if(!storesDataInMemory()) {
         if(!mTmpFile) RuntimeThrow("No tmp file, and no data in memory");
-        dst.writeFile(mTmpFile.get());
+        const auto data = mTmpFile->read();
+        dst.write(data.data(), data.size());
     } else mSurface.write(dst);
 }
 
@@ -317,7 +318,7 @@ QRect DrawableAutoTiledSurface::pixRectToTileRect(const QRect &pixRect) const {
 class SurfaceSaver : public TmpSaver {
     e_OBJECT
     public:
-        typedef std::function<void(const qsptr<QTemporaryFile>&)> Func;
+        typedef std::function<void(const stdsptr<ArenaSpan>&)> Func;
 protected:
     SurfaceSaver(DrawableAutoTiledSurface* const target,
                  const UndoableAutoTiledSurface &surface) :
@@ -339,7 +340,7 @@ class SurfaceLoader : public TmpLoader {
 public:
     typedef std::function<void(UndoableAutoTiledSurface&&)> Func;
 protected:
-    SurfaceLoader(const qsptr<QTemporaryFile> &file,
+    SurfaceLoader(const stdsptr<ArenaSpan> &file,
                   DrawableAutoTiledSurface* const target,
                   const Func& finishedFunc) :
         TmpLoader(file, target),
@@ -35,6 +35,8 @@ protected:
     int getByteCount();
     int clearMemory();
     void noDataLeft_k() { Q_ASSERT(false); }
+    // paint data cannot be dropped, it has to fit in the hdd cache
+    bool canFreeRAM() const { return mTmpFile || !CacheArena::sFull(); }
 public:
     void drawOnCanvas(SkCanvas * const canvas,
                       const SkPoint &dst,
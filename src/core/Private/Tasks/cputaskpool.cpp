@@ -0,0 +1,156 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "cputaskpool.h"
+
+#include <QThread>
+#include <chrono>
+
+static thread_local int tCurrentWorker = -1;
+
+CpuTaskPool::CpuTaskPool() {
+    const int nWorkers = qMax(1, QThread::idealThreadCount());
+    for(int i = 0; i < nWorkers; i++) {
+        mWorkers.push_back(std::make_unique<Worker>());
+    }
+}
+
+int CpuTaskPool::registerWorker() {
+    const int id = mRegistered++;
+    Q_ASSERT(id < int(mWorkers.size()));
+    return id % int(mWorkers.size());
+}
+
+void CpuTaskPool::setCurrentThreadWorker(const int id) {
+    tCurrentWorker = id;
+}
+
+void CpuTaskPool::add(const stdsptr<eTask>& task) {
+    if(tCurrentWorker >= 0) {
+        push(*mWorkers[tCurrentWorker], task);
+    } else {
+        const int nWorkers = qBound(1, int(mRegistered),
+                                    int(mWorkers.size()));
+        const int id = mNextWorker++ % nWorkers;
+        push(*mWorkers[id], task);
+    }
+}
+
+void CpuTaskPool::add(const QList<stdsptr<eTask>>& tasks) {
+    for(const auto& task : tasks) add(task);
+}
+
+void CpuTaskPool::push(Worker& worker, const stdsptr<eTask>& task) {
+    bool sleeping;
+    {
+        std::lock_guard<std::mutex> lk(worker.fMutex);
+        worker.fTasks.push_back(task);
+        worker.fQueued++;
+        mQueued++;
+        sleeping = worker.fSleeping;
+        if(sleeping) worker.fCv.notify_one();
+    }
+    if(!sleeping) {
+        const int id = int(&worker - mWorkers.front().get());
+        wakeOneSleeping(id);
+    }
+}
+
+void CpuTaskPool::wake(Worker& worker) {
+    std::lock_guard<std::mutex> lk(worker.fMutex);
+    worker.fCv.notify_one();
+}
+
+void CpuTaskPool::wakeOneSleeping(const int except) {
+    const int nWorkers = int(mWorkers.size());
+    for(int i = 1; i < nWorkers; i++) {
+        auto& worker = *mWorkers[(except + i) % nWorkers];
+        if(!worker.fSleeping) continue;
+        wake(worker);
+        return;
+    }
+}
+
+bool CpuTaskPool::takeOwn(Worker& worker, stdsptr<eTask>& task) {
+    std::lock_guard<std::mutex> lk(worker.fMutex);
+    if(worker.fTasks.empty()) return false;
+    task = worker.fTasks.front();
+    worker.fTasks.pop_front();
+    worker.fQueued--;
+    mQueued--;
+    return true;
+}
+
+bool CpuTaskPool::steal(const int id, stdsptr<eTask>& task) {
+    const int nWorkers = int(mWorkers.size());
+    for(int i = 1; i < nWorkers; i++) {
+        auto& victim = *mWorkers[(id + i) % nWorkers];
+        if(victim.fQueued == 0) continue;
+        std::lock_guard<std::mutex> lk(victim.fMutex);
+        if(victim.fTasks.empty()) continue;
+        task = victim.fTasks.back();
+        victim.fTasks.pop_back();
+        victim.fQueued--;
+        mQueued--;
+        mWorkers[id]->fSteals++;
+        return true;
+    }
+    return false;
+}
+
+bool CpuTaskPool::waitTake(const int id, stdsptr<eTask>& task,
+                           const std::atomic<bool>& stop) {
+    using namespace std::chrono;
+    auto& worker = *mWorkers[id];
+    bool idle = false;
+    steady_clock::time_point idleStart;
+    while(true) {
+        if(takeOwn(worker, task) || steal(id, task)) {
+            if(idle) {
+                const auto idleTime = steady_clock::now() - idleStart;
+                worker.fIdleUs += duration_cast<microseconds>(idleTime).count();
+            }
+            worker.fProcessed++;
+            return true;
+        }
+        if(stop) return false;
+        if(!idle) {
+            idle = true;
+            idleStart = steady_clock::now();
+        }
+        std::unique_lock<std::mutex> lk(worker.fMutex);
+        worker.fSleeping = true;
+        // pushers increment mQueued before checking fSleeping,
+        // so either we see the new task here or they wake us up
+        if(mQueued == 0) worker.fCv.wait_for(lk, seconds(1));
+        worker.fSleeping = false;
+    }
+}
+
+QList<CpuWorkerStats> CpuTaskPool::stats() const {
+    QList<CpuWorkerStats> result;
+    const int nWorkers = qMin(int(mRegistered), int(mWorkers.size()));
+    for(int i = 0; i < nWorkers; i++) {
+        const auto& worker = *mWorkers[i];
+        CpuWorkerStats stats;
+        stats.fQueued = worker.fQueued;
+        stats.fProcessed = worker.fProcessed;
+        stats.fSteals = worker.fSteals;
+        stats.fIdleMs = worker.fIdleUs/1000;
+        result << stats;
+    }
+    return result;
+}
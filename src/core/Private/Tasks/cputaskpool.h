@@ -0,0 +1,81 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CPUTASKPOOL_H
+#define CPUTASKPOOL_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "Tasks/etask.h"
+
+struct CORE_EXPORT CpuWorkerStats {
+    int fQueued = 0;
+    qint64 fProcessed = 0;
+    qint64 fSteals = 0;
+    qint64 fIdleMs = 0;
+};
+
+// Per-worker task deques with stealing.
+// Tasks added from a worker thread go to that worker's own deque,
+// tasks added from any other thread are distributed round-robin.
+// Idle workers steal from the back of their siblings' deques
+// and only the workers that actually received work are woken up.
+class CORE_EXPORT CpuTaskPool {
+public:
+    CpuTaskPool();
+
+    int registerWorker();
+    void setCurrentThreadWorker(const int id);
+
+    void add(const stdsptr<eTask>& task);
+    void add(const QList<stdsptr<eTask>>& tasks);
+
+    bool waitTake(const int id, stdsptr<eTask>& task,
+                  const std::atomic<bool>& stop);
+
+    int count() const { return mQueued; }
+    QList<CpuWorkerStats> stats() const;
+private:
+    struct Worker {
+        mutable std::mutex fMutex;
+        std::condition_variable fCv;
+        std::deque<stdsptr<eTask>> fTasks;
+        std::atomic<bool> fSleeping{false};
+        std::atomic<int> fQueued{0};
+        std::atomic<qint64> fProcessed{0};
+        std::atomic<qint64> fSteals{0};
+        std::atomic<qint64> fIdleUs{0};
+    };
+
+    void push(Worker& worker, const stdsptr<eTask>& task);
+    void wake(Worker& worker);
+    void wakeOneSleeping(const int except);
+
+    bool takeOwn(Worker& worker, stdsptr<eTask>& task);
+    bool steal(const int id, stdsptr<eTask>& task);
+
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    std::atomic<int> mRegistered{0};
+    std::atomic<int> mNextWorker{0};
+    std::atomic<int> mQueued{0};
+};
+
+#endif // CPUTASKPOOL_H
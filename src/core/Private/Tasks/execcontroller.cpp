@@ -78,3 +78,18 @@ HddExecController::HddExecController(QObject* const parent) :
     ExecController(new HddTaskExecutor, parent) {
     start();
 }
+
+SpillExecController::SpillExecController(QObject* const parent) :
+    ExecController(new SpillTaskExecutor, parent) {
+    start();
+}
+
+AudioExecController::AudioExecController(QObject* const parent) :
+    ExecController(new AudioTaskExecutor, parent) {
+    start();
+}
+
+EncodeExecController::EncodeExecController(QObject* const parent) :
+    ExecController(new EncodeTaskExecutor, parent) {
+    start();
+}
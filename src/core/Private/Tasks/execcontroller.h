@@ -56,4 +56,19 @@ public:
     HddExecController(QObject * const parent = nullptr);
 };
 
+class CORE_EXPORT SpillExecController : public ExecController {
+public:
+    SpillExecController(QObject * const parent = nullptr);
+};
+
+class CORE_EXPORT AudioExecController : public ExecController {
+public:
+    AudioExecController(QObject * const parent = nullptr);
+};
+
+class CORE_EXPORT EncodeExecController : public ExecController {
+public:
+    EncodeExecController(QObject * const parent = nullptr);
+};
+
 #endif // EXECCONTROLLER_H
@@ -16,21 +16,23 @@
 
 #include "taskexecutor.h"
 
+#include <QElapsedTimer>
+
 QAtomicInt TaskExecutor::sTaskFinishSignals = 0;
 
 void TaskExecutor::processTask(eTask& task) {
     task.process();
 }
 
-QAtomicList<stdsptr<eTask>> CpuTaskExecutor::sTasks;
+CpuTaskPool CpuTaskExecutor::sTasks;
 QAtomicInt CpuTaskExecutor::sUseCount = 0;
 
 void CpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.add(ready);
 }
 
 void CpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
-    sTasks.appendAndNotifyAll(ready);
+    sTasks.add(ready);
 }
 
 int CpuTaskExecutor::sUsageCount() {
@@ -41,6 +43,19 @@ int CpuTaskExecutor::sWaitingTasks() {
     return sTasks.count();
 }
 
+QList<CpuWorkerStats> CpuTaskExecutor::sWorkerStats() {
+    return sTasks.stats();
+}
+
+void CpuTaskExecutor::start() {
+    sTasks.setCurrentThreadWorker(mWorkerId);
+    TaskExecutor::start();
+}
+
+bool CpuTaskExecutor::waitTakeTask(stdsptr<eTask>& task) {
+    return sTasks.waitTake(mWorkerId, task, mStop);
+}
+
 void TaskExecutor::start() {
     processLoop();
 }
@@ -49,17 +64,24 @@ void TaskExecutor::stop() {
     mStop = true;
 }
 
+bool TaskExecutor::waitTakeTask(stdsptr<eTask>& task) {
+    return mTasks->waitTakeFirst(task, mStop);
+}
+
 void TaskExecutor::processLoop() {
     mStop = false;
     while(!mStop) {
         stdsptr<eTask> task;
-        if(!mTasks.waitTakeFirst(task, mStop)) break;
+        if(!waitTakeTask(task)) break;
         mUseCount++;
+        QElapsedTimer timer;
+        timer.start();
         try {
             processTask(*task);
         } catch(...) {
             task->setException(std::current_exception());
         }
+        task->addProcessingTime(timer.nsecsElapsed()/1000);
 
         const bool nextStep = !task->waitingToCancel() &&
                               task->nextStep();
@@ -89,3 +111,44 @@ int HddTaskExecutor::sUsageCount() {
 int HddTaskExecutor::sWaitingTasks() {
     return sTasks.count();
 }
+
+QAtomicList<stdsptr<eTask>> SpillTaskExecutor::sTasks;
+QAtomicInt SpillTaskExecutor::sUseCount = 0;
+
+void SpillTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
+    sTasks.appendAndNotifyAll(ready);
+}
+
+int SpillTaskExecutor::sUsageCount() {
+    return sUseCount;
+}
+
+int SpillTaskExecutor::sWaitingTasks() {
+    return sTasks.count();
+}
+
+QAtomicList<stdsptr<eTask>> AudioTaskExecutor::sTasks;
+QAtomicInt AudioTaskExecutor::sUseCount = 0;
+
+void AudioTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
+    sTasks.appendAndNotifyAll(ready);
+}
+
+int AudioTaskExecutor::sUsageCount() {
+    return sUseCount;
+}
+
+int AudioTaskExecutor::sWaitingTasks() {
+    return sTasks.count();
+}
+
+QAtomicList<stdsptr<eTask>> EncodeTaskExecutor::sTasks;
+QAtomicInt EncodeTaskExecutor::sUseCount = 0;
+
+void EncodeTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
+    sTasks.appendAndNotifyAll(ready);
+}
+
+int EncodeTaskExecutor::sUsageCount() {
+    return sUseCount;
+}
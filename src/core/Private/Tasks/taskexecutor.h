@@ -21,13 +21,16 @@
 
 #include "Tasks/updatable.h"
 #include "../qatomiclist.h"
+#include "cputaskpool.h"
 
 class CORE_EXPORT TaskExecutor : public QObject {
     Q_OBJECT
 public:
     TaskExecutor(QAtomicInt& count,
                  QAtomicList<stdsptr<eTask>>& tasks) :
-        mUseCount(count), mTasks(tasks) {}
+        mUseCount(count), mTasks(&tasks) {}
+    TaskExecutor(QAtomicInt& count) :
+        mUseCount(count), mTasks(nullptr) {}
 
     static QAtomicInt sTaskFinishSignals;
 
@@ -37,26 +40,36 @@ signals:
     void finishedTask(const stdsptr<eTask>&);
 protected:
     void processLoop();
-private:
-    virtual void processTask(eTask& task);
+
+    virtual bool waitTakeTask(stdsptr<eTask>& task);
 
     std::atomic<bool> mStop;
+private:
+    virtual void processTask(eTask& task);
 
     QAtomicInt& mUseCount;
-    QAtomicList<stdsptr<eTask>>& mTasks;
+    QAtomicList<stdsptr<eTask>>* const mTasks;
 };
 
 class CORE_EXPORT CpuTaskExecutor : public TaskExecutor {
 public:
-    CpuTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    CpuTaskExecutor() : TaskExecutor(sUseCount),
+        mWorkerId(sTasks.registerWorker()) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
     static int sUsageCount();
     static int sWaitingTasks();
+    static QList<CpuWorkerStats> sWorkerStats();
+
+    void start();
+protected:
+    bool waitTakeTask(stdsptr<eTask>& task);
 private:
+    const int mWorkerId;
+
     static QAtomicInt sUseCount;
-    static QAtomicList<stdsptr<eTask>> sTasks;
+    static CpuTaskPool sTasks;
 };
 
 class CORE_EXPORT HddTaskExecutor : public TaskExecutor {
@@ -72,4 +85,45 @@ private:
     static QAtomicList<stdsptr<eTask>> sTasks;
 };
 
+//! @brief Writes data out to the hdd cache,
+//! separate from HddTaskExecutor so spilling does not delay reads.
+class CORE_EXPORT SpillTaskExecutor : public TaskExecutor {
+public:
+    SpillTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+
+    static void sAddTasks(const QList<stdsptr<eTask>>& ready);
+    static int sUsageCount();
+    static int sWaitingTasks();
+private:
+    static QAtomicInt sUseCount;
+    static QAtomicList<stdsptr<eTask>> sTasks;
+};
+
+//! @brief Reads and mixes sound seconds ahead of playback,
+//! separate from HddTaskExecutor so busy media reads do not starve audio.
+class CORE_EXPORT AudioTaskExecutor : public TaskExecutor {
+public:
+    AudioTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+
+    static void sAddTasks(const QList<stdsptr<eTask>>& ready);
+    static int sUsageCount();
+    static int sWaitingTasks();
+private:
+    static QAtomicInt sUseCount;
+    static QAtomicList<stdsptr<eTask>> sTasks;
+};
+
+//! @brief Dedicated output encoding stage,
+//! kept out of the hdd pool so rendering is not blocked by encoding.
+class CORE_EXPORT EncodeTaskExecutor : public TaskExecutor {
+public:
+    EncodeTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+
+    static void sAddTask(const stdsptr<eTask>& ready);
+    static int sUsageCount();
+private:
+    static QAtomicInt sUseCount;
+    static QAtomicList<stdsptr<eTask>> sTasks;
+};
+
 #endif // TASKEXECUTOR_H
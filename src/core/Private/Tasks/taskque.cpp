@@ -17,7 +17,10 @@
 #include "taskque.h"
 #include "Private/esettings.h"
 
-TaskQue::TaskQue() {}
+TaskQue::TaskQue(const TaskPriority priority,
+                 const Canvas* const scene,
+                 const int frame) :
+    mPriority(priority), mScene(scene), mFrame(frame) {}
 
 TaskQue::~TaskQue() {
     for(const auto& task : mCpuOnly) task->cancel();
@@ -18,10 +18,22 @@
 #define TASKQUE_H
 #include "Tasks/updatable.h"
 
+class Canvas;
+
+enum class TaskPriority {
+    interactive, // current frame of the active scene
+    visible, // current frames of the other visible scenes
+    preview, // frames rendered ahead for preview and output
+    audio, // sound seconds within the playback look-ahead window
+    spill // moving cache to the hard drive
+};
+
 class CORE_EXPORT TaskQue {
     friend class TaskQueHandler;
 public:
-    explicit TaskQue();
+    explicit TaskQue(const TaskPriority priority,
+                     const Canvas* const scene,
+                     const int frame);
     TaskQue(const TaskQue&) = delete;
     TaskQue& operator=(const TaskQue&) = delete;
 
@@ -33,7 +45,15 @@ protected:
 
     stdsptr<eTask> takeQuedForCpuProcessing();
     stdsptr<eTask> takeQuedForGpuProcessing();
+
+    TaskPriority priority() const { return mPriority; }
+    const Canvas* scene() const { return mScene; }
+    int frame() const { return mFrame; }
 private:
+    const TaskPriority mPriority;
+    const Canvas* const mScene;
+    const int mFrame;
+
     QList<stdsptr<eTask>> mGpuOnly;
     QList<stdsptr<eTask>> mGpuPreffered;
     QList<stdsptr<eTask>> mCpuPreffered;
@@ -54,10 +54,16 @@ stdsptr<eTask> TaskQueHandler::takeQuedForCpuProcessing() {
     return nullptr;
 }
 
-void TaskQueHandler::beginQue() {
+void TaskQueHandler::beginQue(const TaskPriority priority,
+                              const Canvas* const scene,
+                              const int frame) {
     if(mCurrentQue) RuntimeThrow("Previous list not ended");
-    mQues << std::make_shared<TaskQue>();
-    mCurrentQue = mQues.last().get();
+    const auto que = std::make_shared<TaskQue>(priority, scene, frame);
+    // keep ques ordered by priority, first come first served within one
+    int id = mQues.count();
+    while(id > 0 && mQues.at(id - 1)->priority() > priority) id--;
+    mQues.insert(id, que);
+    mCurrentQue = que.get();
 }
 
 void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
@@ -70,9 +76,16 @@ void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
             addTask(task);
             endQue();
         } else {
-            const auto que = mQues.first().get();
-            que->addTask(task);
-            mTaskCount++;
+            // tasks not qued for a scene frame never go stale
+            for(const auto& que : mQues) {
+                if(que->scene()) continue;
+                que->addTask(task);
+                mTaskCount++;
+                return;
+            }
+            beginQue();
+            addTask(task);
+            endQue();
         }
     }
 }
@@ -80,10 +93,31 @@ void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
 void TaskQueHandler::endQue() {
     if(!mCurrentQue) return;
     const int count = mCurrentQue->countQued();
-    if(count == 0) mQues.removeLast();
+    if(count == 0) {
+        for(int i = 0; i < mQues.count(); i++) {
+            if(mQues.at(i).get() != mCurrentQue) continue;
+            mQues.removeAt(i);
+            break;
+        }
+    }
     mCurrentQue = nullptr;
 }
 
+int TaskQueHandler::cancelStale(const Canvas* const scene, const int frame) {
+    int canceled = 0;
+    for(int i = mQues.count() - 1; i >= 0; i--) {
+        const auto que = mQues.at(i).get();
+        if(que == mCurrentQue) continue;
+        if(que->scene() != scene || que->frame() == frame) continue;
+        const int count = que->countQued();
+        mTaskCount -= count;
+        canceled += count;
+        // remaining tasks get canceled by the TaskQue destructor
+        mQues.removeAt(i);
+    }
+    return canceled;
+}
+
 void TaskQueHandler::queDone(const TaskQue * const que, const int queId) {
     if(que == mCurrentQue) return;
     mQues.removeAt(queId);
@@ -28,12 +28,16 @@ public:
     stdsptr<eTask> takeQuedForGpuProcessing();
     stdsptr<eTask> takeQuedForCpuProcessing();
 
-    void beginQue();
+    void beginQue(const TaskPriority priority = TaskPriority::interactive,
+                  const Canvas* const scene = nullptr,
+                  const int frame = 0);
 
     void addTask(const stdsptr<eTask>& task);
 
     void endQue();
 
+    int cancelStale(const Canvas* const scene, const int frame);
+
     int taskCount() const { return mTaskCount; }
 private:
     void queDone(const TaskQue * const que, const int queId);
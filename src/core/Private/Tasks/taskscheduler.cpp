@@ -39,10 +39,27 @@ TaskScheduler::TaskScheduler() {
         mCpuExecs << taskExecutor;
     }
 
-    mHddExec = std::make_shared<HddExecController>(this);
-    connect(mHddExec.get(), &ExecController::finishedTaskSignal,
+    const int numberHddThreads = eSettings::sHddThreads();
+    for(int i = 0; i < numberHddThreads; i++) {
+        const auto hddExecutor = std::make_shared<HddExecController>(this);
+        connect(hddExecutor.get(), &ExecController::finishedTaskSignal,
+                this, &TaskScheduler::afterHddTaskFinished);
+
+        mHddExecs << hddExecutor;
+    }
+
+    mSpillExec = std::make_shared<SpillExecController>(this);
+    connect(mSpillExec.get(), &ExecController::finishedTaskSignal,
             this, &TaskScheduler::afterHddTaskFinished);
 
+    mAudioExec = std::make_shared<AudioExecController>(this);
+    connect(mAudioExec.get(), &ExecController::finishedTaskSignal,
+            this, &TaskScheduler::afterHddTaskFinished);
+
+    mEncodeExec = std::make_shared<EncodeExecController>(this);
+    connect(mEncodeExec.get(), &ExecController::finishedTaskSignal,
+            this, &TaskScheduler::afterEncodeTaskFinished);
+
     mGpuExec = std::make_shared<GpuExecController>(this);
     connect(mGpuExec.get(), &ExecController::finishedTaskSignal,
             this, &TaskScheduler::afterCpuGpuTaskFinished);
@@ -52,7 +69,12 @@ TaskScheduler::~TaskScheduler() {
     for(const auto& exec : mCpuExecs) {
         exec->stopAndWait();
     }
-    mHddExec->stopAndWait();
+    for(const auto& exec : mHddExecs) {
+        exec->stopAndWait();
+    }
+    mSpillExec->stopAndWait();
+    mAudioExec->stopAndWait();
+    mEncodeExec->stopAndWait();
     mGpuExec->stopAndWait();
 }
 
@@ -89,8 +111,11 @@ void TaskScheduler::initializeGpu() {
     }
 }
 
-void TaskScheduler::queHddTask(const stdsptr<eTask>& task) {
-    mQuedHddTasks << task;
+void TaskScheduler::queHddTask(const stdsptr<eTask>& task,
+                               const TaskPriority priority) {
+    if(priority == TaskPriority::spill) mQuedSpillTasks << task;
+    else if(priority == TaskPriority::audio) mQuedAudioTasks << task;
+    else mQuedHddTasks << task;
     processNextQuedHddTask();
 }
 
@@ -104,12 +129,23 @@ void TaskScheduler::queCpuTask(const stdsptr<eTask>& task) {
     }
 }
 
+void TaskScheduler::queEncodeTask(const stdsptr<eTask>& task) {
+    task->aboutToProcess(Hardware::hdd);
+    EncodeTaskExecutor::sAddTask(task);
+}
+
 void TaskScheduler::clearTasks() {
     mQuedCGTasks.clear();
 
     for(const auto& hddTask : mQuedHddTasks)
         hddTask->cancel();
     mQuedHddTasks.clear();
+    for(const auto& spillTask : mQuedSpillTasks)
+        spillTask->cancel();
+    mQuedSpillTasks.clear();
+    for(const auto& audioTask : mQuedAudioTasks)
+        audioTask->cancel();
+    mQuedAudioTasks.clear();
 
     callAllTasksFinishedFunc();
 }
@@ -135,7 +171,8 @@ bool TaskScheduler::shouldQueMoreCpuTasks() const {
 
 bool TaskScheduler::shouldQueMoreHddTasks() const {
     return !mCpuQueing && !overflowed() &&
-            mQuedHddTasks.count() + HddTaskExecutor::sWaitingTasks() < 2;
+            mQuedHddTasks.count() + HddTaskExecutor::sWaitingTasks() <
+            2*mHddExecs.count();
 }
 
 void TaskScheduler::queTasks() {
@@ -144,19 +181,33 @@ void TaskScheduler::queTasks() {
 }
 
 void TaskScheduler::queScheduledCpuTasks() {
+    if(!mAlwaysQue) cancelStaleTasks();
     if(!mAlwaysQue && !shouldQueMoreCpuTasks()) return;
     mCpuQueing = true;
-    mQuedCGTasks.beginQue();
+    const auto activeScene = *Document::sInstance->fActiveScene;
     for(const auto& it : Document::sInstance->fVisibleScenes) {
         const auto scene = it.first;
+        TaskPriority priority;
+        if(mAlwaysQue) priority = TaskPriority::preview;
+        else if(scene == activeScene) priority = TaskPriority::interactive;
+        else priority = TaskPriority::visible;
+        mQuedCGTasks.beginQue(priority, scene, scene->anim_getCurrentAbsFrame());
         scene->queTasks();
+        mQuedCGTasks.endQue();
     }
-    mQuedCGTasks.endQue();
     mCpuQueing = false;
 
     if(!mQuedCGTasks.isEmpty()) processNextTasks();
 }
 
+void TaskScheduler::cancelStaleTasks() {
+    for(const auto& it : Document::sInstance->fVisibleScenes) {
+        const auto scene = it.first;
+        const int frame = scene->anim_getCurrentAbsFrame();
+        mQuedCGTasks.cancelStale(scene, frame);
+    }
+}
+
 void TaskScheduler::afterHddTaskFinished(const stdsptr<eTask>& finishedTask) {
     TaskExecutor::sTaskFinishSignals--;
     finishedTask->finishedProcessing();
@@ -167,17 +218,25 @@ void TaskScheduler::afterHddTaskFinished(const stdsptr<eTask>& finishedTask) {
 
 void TaskScheduler::processNextQuedHddTask() {
     bool finished = false;
-    QList<stdsptr<eTask>> tasks;
-    for(int i = 0; i < mQuedHddTasks.count(); i++) {
-        const auto task = mQuedHddTasks.at(i);
-        if(!task->readyToBeProcessed()) continue;
-        task->aboutToProcess(Hardware::hdd);
-        if(task->getState() > eTaskState::processing)
-            finished = true;
-        mQuedHddTasks.removeAt(i--);
-        tasks << task;
-    }
-    if(!tasks.isEmpty()) HddTaskExecutor::sAddTasks(tasks);
+    const auto takeReady = [&finished](QList<stdsptr<eTask>>& from) {
+        QList<stdsptr<eTask>> tasks;
+        for(int i = 0; i < from.count(); i++) {
+            const auto task = from.at(i);
+            if(!task->readyToBeProcessed()) continue;
+            task->aboutToProcess(Hardware::hdd);
+            if(task->getState() > eTaskState::processing)
+                finished = true;
+            from.removeAt(i--);
+            tasks << task;
+        }
+        return tasks;
+    };
+    const auto audioTasks = takeReady(mQuedAudioTasks);
+    if(!audioTasks.isEmpty()) AudioTaskExecutor::sAddTasks(audioTasks);
+    const auto hddTasks = takeReady(mQuedHddTasks);
+    if(!hddTasks.isEmpty()) HddTaskExecutor::sAddTasks(hddTasks);
+    const auto spillTasks = takeReady(mQuedSpillTasks);
+    if(!spillTasks.isEmpty()) SpillTaskExecutor::sAddTasks(spillTasks);
     if(finished) processNextTasks();
 
     emit hddUsageChanged(busyHddThreads());
@@ -224,6 +283,12 @@ void TaskScheduler::afterCpuGpuTaskFinished(const stdsptr<eTask>& task) {
     callAllTasksFinishedFunc();
 }
 
+void TaskScheduler::afterEncodeTaskFinished(const stdsptr<eTask>& task) {
+    TaskExecutor::sTaskFinishSignals--;
+    task->finishedProcessing();
+    callAllTasksFinishedFunc();
+}
+
 void TaskScheduler::setTaskUnderflowFunc(const Func& func) {
     mTaskUnderflowFunc = func;
 }
@@ -248,7 +313,8 @@ bool TaskScheduler::allQuedCpuTasksFinished() const {
 }
 
 bool TaskScheduler::allQuedHddTasksFinished() const {
-    return mQuedHddTasks.isEmpty() && !hddTaskBeingProcessed();
+    return mQuedHddTasks.isEmpty() && mQuedSpillTasks.isEmpty() &&
+           mQuedAudioTasks.isEmpty() && !hddTaskBeingProcessed();
 }
 
 bool TaskScheduler::cpuTasksBeingProcessed() const {
@@ -260,7 +326,8 @@ bool TaskScheduler::hddTaskBeingProcessed() const {
 }
 
 int TaskScheduler::busyHddThreads() const {
-    return HddTaskExecutor::sUsageCount();
+    return HddTaskExecutor::sUsageCount() + SpillTaskExecutor::sUsageCount() +
+           AudioTaskExecutor::sUsageCount();
 }
 
 int TaskScheduler::busyCpuThreads() const {
@@ -26,6 +26,9 @@
 class Canvas;
 class CpuExecController;
 class HddExecController;
+class SpillExecController;
+class AudioExecController;
+class EncodeExecController;
 class GpuExecController;
 class ComplexTask;
 
@@ -50,13 +53,16 @@ public:
     void initializeGpu();
 
     void queTasks();
-    void queHddTask(const stdsptr<eTask>& task);
+    void queHddTask(const stdsptr<eTask>& task,
+                    const TaskPriority priority = TaskPriority::visible);
     void queCpuTask(const stdsptr<eTask> &task);
+    void queEncodeTask(const stdsptr<eTask>& task);
 
     void clearTasks();
 
     void afterHddTaskFinished(const stdsptr<eTask>& finishedTask);
     void afterCpuGpuTaskFinished(const stdsptr<eTask>& task);
+    void afterEncodeTaskFinished(const stdsptr<eTask>& task);
 
     void setTaskUnderflowFunc(const Func& func);
     void setAllTasksFinishedFunc(const Func& func);
@@ -91,6 +97,7 @@ signals:
     void complexTaskAdded(ComplexTask*);
 private:
     void queScheduledCpuTasks();
+    void cancelStaleTasks();
 
     void processNextQuedHddTask();
     void processNextQuedCpuTask();
@@ -114,10 +121,15 @@ private:
 
     TaskQueHandler mQuedCGTasks;
     QList<stdsptr<eTask>> mQuedHddTasks;
+    QList<stdsptr<eTask>> mQuedSpillTasks;
+    QList<stdsptr<eTask>> mQuedAudioTasks;
 
     QList<stdsptr<CpuExecController>> mCpuExecs;
     stdsptr<GpuExecController> mGpuExec;
-    stdsptr<HddExecController> mHddExec;
+    QList<stdsptr<HddExecController>> mHddExecs;
+    stdsptr<SpillExecController> mSpillExec;
+    stdsptr<AudioExecController> mAudioExec;
+    stdsptr<EncodeExecController> mEncodeExec;
 
     Func mTaskUnderflowFunc;
     Func mAllTasksFinishedFunc;
@@ -163,12 +163,24 @@ eSettings::eSettings(const int cpuThreads, const intKB ramKB,
     gSettings << std::make_shared<eBoolSetting>(
                      fPathGpuAcc,
                      "pathGpuAcc", true);
+    gSettings << std::make_shared<eBoolSetting>(
+                     fFuseCpuEffects,
+                     "fuseCpuEffects", true);
     gSettings << std::make_shared<eBoolSetting>(
                      fHddCache,
                      "hddCache", true);
     gSettings << std::make_shared<eIntSetting>(
                      reinterpret_cast<int&>(fHddCacheMBCap),
                      "hddCacheMBCap", 0);
+    gSettings << std::make_shared<eIntSetting>(
+                     fHddThreads,
+                     "hddThreads", 1);
+    gSettings << std::make_shared<eIntSetting>(
+                     fOutputFramesInFlight,
+                     "outputFramesInFlight", 1);
+    gSettings << std::make_shared<eIntSetting>(
+                     fAudioLookAheadSeconds,
+                     "audioLookAheadSeconds", 4);
 
     gSettings << std::make_shared<eQrealSetting>(
                      fInterfaceScaling,
@@ -276,6 +288,10 @@ int eSettings::sCpuThreadsCapped() {
     return sInstance->fCpuThreads;
 }
 
+int eSettings::sHddThreads() {
+    return qBound(1, sInstance->fHddThreads, 16);
+}
+
 intMB eSettings::sRamMBCap() {
     if(sInstance->fRamMBCap.fValue > 0) return sInstance->fRamMBCap;
     auto mbTot = intMB(sInstance->fRamKB);
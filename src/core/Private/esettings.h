@@ -48,6 +48,7 @@ public:
     // accessors
     static intMB sRamMBCap();
     static int sCpuThreadsCapped();
+    static int sHddThreads();
     static const QString& sSettingsDir();
     static const QString& sIconsDir();
 
@@ -75,11 +76,18 @@ public:
     const GpuVendor fGpuVendor;
     AccPreference fAccPreference = AccPreference::defaultPreference;
     bool fPathGpuAcc = true;
+    bool fFuseCpuEffects = true; // point-wise raster effects in one pass
 
     bool fHddCache = true;
     QString fHddCacheFolder = ""; // "" - use system default temporary files folder
     intMB fHddCacheMBCap = intMB(0); // <= 0 - no cap
 
+    int fHddThreads = 1; // threads reading from the drive, applied on restart
+
+    int fOutputFramesInFlight = 1; // <= 1 - one frame at a time
+
+    int fAudioLookAheadSeconds = 4; // <= 0 - no look-ahead
+
     // history
     int fUndoCap = 25; // <= 0 - no cap
 
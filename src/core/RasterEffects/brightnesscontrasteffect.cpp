@@ -17,6 +17,7 @@
 #include "brightnesscontrasteffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -44,6 +45,7 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sBrightnessU = gl->glGetUniformLocation(sProgramId, "brightness");
@@ -88,22 +90,33 @@ stdsptr<RasterEffectCaller> BrightnessContrastEffect::getEffectCaller(
 void BrightnessContrastEffectCaller::processCpu(CpuRenderTools& renderTools,
                                                 const CpuRenderData& data) {
     const int xMin = data.fTexTile.left();
-    const int xMax = data.fTexTile.right();
+    const int xMax = data.fTexTile.right() - 1;
     const int yMin = data.fTexTile.top();
-    const int yMax = data.fTexTile.bottom();
+    const int yMax = data.fTexTile.bottom() - 1;
 
+    const auto channel = [this](const uchar c, const uchar a) {
+        const qreal v = (c - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
+        return static_cast<uchar>(qBound(0., v, 255.));
+    };
+
+    const int width = xMax - xMin + 1;
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
+        const int done = PixelKernels::brightnessContrast(
+                    src, dst, width, static_cast<float>(mBrightness),
+                    static_cast<float>(mContrast));
+        src += 4*done;
+        dst += 4*done;
+        for(int xi = xMin + done; xi <= xMax; xi++) {
             const uchar r = *src++;
             const uchar g = *src++;
             const uchar b = *src++;
             const uchar a = *src++;
 
-            *dst++ = (r - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (g - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (b - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
+            *dst++ = channel(r, a);
+            *dst++ = channel(g, a);
+            *dst++ = channel(b, a);
             *dst++ = a;
         }
     }
@@ -17,6 +17,7 @@
 #include "colorizeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -57,6 +58,7 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sInfluenceU = gl->glGetUniformLocation(sProgramId, "influence");
@@ -113,14 +115,20 @@ stdsptr<RasterEffectCaller> ColorizeEffect::getEffectCaller(
 void ColorizeEffectCaller::processCpu(CpuRenderTools& renderTools,
                                       const CpuRenderData& data) {
     const int xMin = data.fTexTile.left();
-    const int xMax = data.fTexTile.right();
+    const int xMax = data.fTexTile.right() - 1;
     const int yMin = data.fTexTile.top();
-    const int yMax = data.fTexTile.bottom();
+    const int yMax = data.fTexTile.bottom() - 1;
 
+    const PixelKernels::ColorizeParams params(mHue/360., mSaturation,
+                                              mLightness, mInfluence);
+    const int width = xMax - xMin + 1;
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
+        const int done = PixelKernels::colorize(src, dst, width, params);
+        src += 4*done;
+        dst += 4*done;
+        for(int xi = xMin + done; xi <= xMax; xi++) {
             const uchar texR = *src++;
             const uchar texG = *src++;
             const uchar texB = *src++;
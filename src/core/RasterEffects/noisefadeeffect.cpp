@@ -17,6 +17,7 @@
 #include "noisefadeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "Animators/qrealanimator.h"
 
@@ -53,6 +54,7 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sSeedU = gl->glGetUniformLocation(sProgramId, "seed");
@@ -68,9 +70,18 @@ protected:
         gl->glUniform1f(sTimeU, mTime);
     }
 private:
+    //! @brief Hashes of the lattice cell corners last used by an octave,
+    //! neighbouring pixels mostly fall into the same cell.
+    struct LatticeCell {
+        qreal fX = qQNaN();
+        qreal fY = qQNaN();
+        qreal fR[4];
+    };
+    using Octaves = LatticeCell[6];
+
     qreal r(const QPointF& p) const;
-    qreal n(const QPointF& p) const;
-    qreal noise(const QPointF& p) const;
+    qreal n(const QPointF& p, LatticeCell& cell) const;
+    qreal noise(const QPointF& p, Octaves& octaves) const;
 
     static bool sInitialized;
     static GLuint sProgramId;
@@ -145,27 +156,33 @@ qreal NoiseFadeEffectCaller::r(const QPointF& p) const {
                           (p.y() + 0.00001*mSeed)*43.23) * 1127.53);
 }
 
-qreal NoiseFadeEffectCaller::n(const QPointF& p) const {
+qreal NoiseFadeEffectCaller::n(const QPointF& p, LatticeCell& cell) const {
     const QPointF fn = GLSL_floor(p);
     const QPointF sn = GLSL_smoothstep(QPointF{0. ,0.},
                                        QPointF{1., 1.},
                                        GLSL_fract(p));
+    if(fn.x() != cell.fX || fn.y() != cell.fY) {
+        cell.fX = fn.x();
+        cell.fY = fn.y();
+        cell.fR[0] = r(fn);
+        cell.fR[1] = r(fn + QPointF{1., 0.});
+        cell.fR[2] = r(fn + QPointF{0., 1.});
+        cell.fR[3] = r(fn + QPointF{1., 1.});
+    }
 
-    const qreal h1 = GLSL_mix(r(fn),
-                              r(fn + QPointF{1., 0.}), sn.x());
-    const qreal h2 = GLSL_mix(r(fn + QPointF{0., 1.}),
-                              r(fn + QPointF{1., 1.}), sn.x());
+    const qreal h1 = GLSL_mix(cell.fR[0], cell.fR[1], sn.x());
+    const qreal h2 = GLSL_mix(cell.fR[2], cell.fR[3], sn.x());
     return GLSL_mix(h1 ,h2, sn.y());
 }
 
-qreal NoiseFadeEffectCaller::noise(const QPointF& p) const {
+qreal NoiseFadeEffectCaller::noise(const QPointF& p, Octaves& octaves) const {
     const qreal s = mSize*0.001;
-    return 0.58 * n(p/(32.*s)) +
-           0.2 * n(p/(16.*s)) +
-           0.1 * n(p/(8.*s)) +
-           0.05 * n(p/(4.*s)) +
-           0.02 * n(p/(2.*s)) +
-           0.0125 * n(p/s);
+    return 0.58 * n(p/(32.*s), octaves[0]) +
+           0.2 * n(p/(16.*s), octaves[1]) +
+           0.1 * n(p/(8.*s), octaves[2]) +
+           0.05 * n(p/(4.*s), octaves[3]) +
+           0.02 * n(p/(2.*s), octaves[4]) +
+           0.0125 * n(p/s, octaves[5]);
 }
 
 void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
@@ -174,13 +191,16 @@ void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const qreal imgHeight = renderTools.fSrcBtmp.height();
 
     const int xMin = data.fTexTile.left();
-    const int xMax = data.fTexTile.right();
+    const int xMax = data.fTexTile.right() - 1;
     const int yMin = data.fTexTile.top();
-    const int yMax = data.fTexTile.bottom();
+    const int yMax = data.fTexTile.bottom() - 1;
 
     const qreal t = abs(sin(0.5*PI*mTime));
     const qreal b = 0.25*(0.75 - 0.749*mSharpness);
 
+    const int width = xMax - xMin + 1;
+    std::vector<float> factors(static_cast<size_t>(width));
+    Octaves octaves;
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
@@ -188,10 +208,18 @@ void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
             const qreal x = xi/imgWidth;
             const qreal y = yi/imgHeight;
 
-            const qreal c = GLSL_smoothstep(t + b, t - b, noise(QPointF{x, y} * .4));
+            const qreal c = GLSL_smoothstep(t + b, t - b,
+                                            noise(QPointF{x, y} * .4, octaves));
+            factors[static_cast<size_t>(xi - xMin)] = static_cast<float>(1 - c);
+        }
 
+        const int done = PixelKernels::scale(src, dst, factors.data(), width);
+        src += 4*done;
+        dst += 4*done;
+        for(int xi = done; xi < width; xi++) {
+            const float factor = factors[static_cast<size_t>(xi)];
             for(int i = 0; i < 4; i++) {
-                *dst++ = *src++ * (1 - c);
+                *dst++ = *src++ * factor;
             }
         }
     }
@@ -0,0 +1,369 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "pixelkernels.h"
+
+#include <cmath>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define PIXELKERNELS_X86
+    #define TARGET_SSE41 __attribute__((target("sse4.1")))
+    #define TARGET_AVX2 __attribute__((target("avx2")))
+    #include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #define PIXELKERNELS_X86
+    #define TARGET_SSE41
+    #define TARGET_AVX2
+    #include <immintrin.h>
+    #include <intrin.h>
+#endif
+
+using Isa = PixelKernels::Isa;
+
+static Isa detectIsa() {
+#if defined(PIXELKERNELS_X86) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return Isa::avx2;
+    if(__builtin_cpu_supports("sse4.1")) return Isa::sse41;
+#elif defined(PIXELKERNELS_X86)
+    int info[4];
+    __cpuid(info, 0);
+    const int nIds = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = info[2] & (1 << 19);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    bool avx2 = false;
+    if(nIds >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = info[1] & (1 << 5);
+    }
+    // the os has to preserve the ymm registers
+    const bool ymm = osxsave && avx && (_xgetbv(0) & 6) == 6;
+    if(avx2 && ymm) return Isa::avx2;
+    if(sse41) return Isa::sse41;
+#endif
+    return Isa::scalar;
+}
+
+static const Isa gSupportedIsa = detectIsa();
+static Isa gIsa = gSupportedIsa;
+
+Isa PixelKernels::isa() { return gIsa; }
+
+Isa PixelKernels::supportedIsa() { return gSupportedIsa; }
+
+void PixelKernels::limitIsa(const Isa max) {
+    gIsa = max < gSupportedIsa ? max : gSupportedIsa;
+}
+
+// hsl_value from colorhelpers with n1 = 0 and n2 = 1
+static qreal hueWeight(qreal hue) {
+    if(hue > 6) hue -= 6;
+    else if(hue < 0) hue += 6;
+    if(hue < 1) return hue;
+    if(hue < 3) return 1;
+    if(hue < 4) return 4 - hue;
+    return 0;
+}
+
+PixelKernels::ColorizeParams::ColorizeParams(
+        const qreal hue, const qreal saturation,
+        const qreal lightness, const qreal influence) :
+    fLightness(static_cast<float>(lightness)),
+    fInfluence(static_cast<float>(influence)) {
+    const qreal h = 6*(hue - std::floor(hue));
+    const qreal s = qBound(0., saturation, 1.);
+    const qreal weights[3] = {hueWeight(h + 2), hueWeight(h), hueWeight(h - 2)};
+    for(int i = 0; i < 3; i++) {
+        fLow[i] = static_cast<float>(1 - s + 2*s*weights[i]);
+        fHigh[i] = static_cast<float>(1 + s - 2*s*weights[i]);
+    }
+}
+
+#ifdef PIXELKERNELS_X86
+
+// pixels are loaded as 32 bit lanes, red in the lowest byte
+
+TARGET_SSE41
+static inline __m128 channelSse41(const __m128i px, const int shift) {
+    const __m128i c = _mm_srl_epi32(px, _mm_cvtsi32_si128(shift));
+    return _mm_cvtepi32_ps(_mm_and_si128(c, _mm_set1_epi32(0xFF)));
+}
+
+TARGET_SSE41
+static inline __m128i packChannelSse41(const __m128 v, const int shift) {
+    // truncates like the scalar conversion to uchar
+    __m128i c = _mm_cvttps_epi32(v);
+    c = _mm_max_epi32(c, _mm_setzero_si128());
+    c = _mm_min_epi32(c, _mm_set1_epi32(0xFF));
+    return _mm_sll_epi32(c, _mm_cvtsi32_si128(shift));
+}
+
+TARGET_AVX2
+static inline __m256 channelAvx2(const __m256i px, const int shift) {
+    const __m256i c = _mm256_srl_epi32(px, _mm_cvtsi32_si128(shift));
+    return _mm256_cvtepi32_ps(_mm256_and_si256(c, _mm256_set1_epi32(0xFF)));
+}
+
+TARGET_AVX2
+static inline __m256i packChannelAvx2(const __m256 v, const int shift) {
+    __m256i c = _mm256_cvttps_epi32(v);
+    c = _mm256_max_epi32(c, _mm256_setzero_si256());
+    c = _mm256_min_epi32(c, _mm256_set1_epi32(0xFF));
+    return _mm256_sll_epi32(c, _mm_cvtsi32_si128(shift));
+}
+
+TARGET_SSE41
+static int brightnessContrastSse41(const uchar* src, uchar* dst,
+                                   const int count,
+                                   const float mul, const float alphaMul) {
+    const __m128 mulV = _mm_set1_ps(mul);
+    const __m128 alphaMulV = _mm_set1_ps(alphaMul);
+    const int n = count & ~3;
+    for(int i = 0; i < n; i += 4) {
+        const auto srcPx = reinterpret_cast<const __m128i*>(src + 4*i);
+        const __m128i px = _mm_loadu_si128(srcPx);
+        const __m128i a = _mm_srli_epi32(px, 24);
+        const __m128 aTerm = _mm_mul_ps(_mm_cvtepi32_ps(a), alphaMulV);
+        __m128i result = _mm_slli_epi32(a, 24);
+        for(int shift = 0; shift < 24; shift += 8) {
+            const __m128 c = channelSse41(px, shift);
+            const __m128 v = _mm_add_ps(_mm_mul_ps(c, mulV), aTerm);
+            result = _mm_or_si128(result, packChannelSse41(v, shift));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+TARGET_AVX2
+static int brightnessContrastAvx2(const uchar* src, uchar* dst,
+                                  const int count,
+                                  const float mul, const float alphaMul) {
+    const __m256 mulV = _mm256_set1_ps(mul);
+    const __m256 alphaMulV = _mm256_set1_ps(alphaMul);
+    const int n = count & ~7;
+    for(int i = 0; i < n; i += 8) {
+        const auto srcPx = reinterpret_cast<const __m256i*>(src + 4*i);
+        const __m256i px = _mm256_loadu_si256(srcPx);
+        const __m256i a = _mm256_srli_epi32(px, 24);
+        const __m256 aTerm = _mm256_mul_ps(_mm256_cvtepi32_ps(a), alphaMulV);
+        __m256i result = _mm256_slli_epi32(a, 24);
+        for(int shift = 0; shift < 24; shift += 8) {
+            const __m256 c = channelAvx2(px, shift);
+            const __m256 v = _mm256_add_ps(_mm256_mul_ps(c, mulV), aTerm);
+            result = _mm256_or_si256(result, packChannelAvx2(v, shift));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+TARGET_SSE41
+static int colorizeSse41(const uchar* src, uchar* dst, const int count,
+                         const PixelKernels::ColorizeParams& params) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 lightness = _mm_set1_ps(params.fLightness);
+    const __m128 infl = _mm_set1_ps(params.fInfluence);
+    const __m128 invInfl = _mm_set1_ps(1 - params.fInfluence);
+    const int n = count & ~3;
+    for(int i = 0; i < n; i += 4) {
+        const auto srcPx = reinterpret_cast<const __m128i*>(src + 4*i);
+        const __m128i px = _mm_loadu_si128(srcPx);
+        const __m128 r = channelSse41(px, 0);
+        const __m128 g = channelSse41(px, 8);
+        const __m128 b = channelSse41(px, 16);
+        const __m128 a = channelSse41(px, 24);
+
+        const __m128 invA = _mm_div_ps(one, a);
+        const __m128 maxC = _mm_max_ps(r, _mm_max_ps(g, b));
+        const __m128 minC = _mm_min_ps(r, _mm_min_ps(g, b));
+        const __m128 maxL = _mm_min_ps(_mm_mul_ps(maxC, invA), one);
+        const __m128 minL = _mm_min_ps(_mm_mul_ps(minC, invA), one);
+        __m128 l = _mm_add_ps(_mm_mul_ps(_mm_add_ps(maxL, minL), half),
+                              lightness);
+        l = _mm_min_ps(_mm_max_ps(l, zero), one);
+        const __m128 lowL = _mm_cmple_ps(l, half);
+        const __m128 invL = _mm_sub_ps(one, l);
+        const __m128 aInfl = _mm_mul_ps(a, infl);
+
+        const __m128 cs[3] = {r, g, b};
+        __m128i result = _mm_slli_epi32(_mm_srli_epi32(px, 24), 24);
+        for(int j = 0; j < 3; j++) {
+            const __m128 low = _mm_mul_ps(l, _mm_set1_ps(params.fLow[j]));
+            const __m128 high = _mm_sub_ps(
+                        one, _mm_mul_ps(invL, _mm_set1_ps(params.fHigh[j])));
+            const __m128 ch = _mm_blendv_ps(high, low, lowL);
+            const __m128 v = _mm_add_ps(_mm_mul_ps(ch, aInfl),
+                                        _mm_mul_ps(cs[j], invInfl));
+            result = _mm_or_si128(result, packChannelSse41(v, 8*j));
+        }
+        const __m128i transparent = _mm_cmpeq_epi32(
+                    _mm_srli_epi32(px, 24), _mm_setzero_si128());
+        result = _mm_andnot_si128(transparent, result);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+TARGET_AVX2
+static int colorizeAvx2(const uchar* src, uchar* dst, const int count,
+                        const PixelKernels::ColorizeParams& params) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 lightness = _mm256_set1_ps(params.fLightness);
+    const __m256 infl = _mm256_set1_ps(params.fInfluence);
+    const __m256 invInfl = _mm256_set1_ps(1 - params.fInfluence);
+    const int n = count & ~7;
+    for(int i = 0; i < n; i += 8) {
+        const auto srcPx = reinterpret_cast<const __m256i*>(src + 4*i);
+        const __m256i px = _mm256_loadu_si256(srcPx);
+        const __m256 r = channelAvx2(px, 0);
+        const __m256 g = channelAvx2(px, 8);
+        const __m256 b = channelAvx2(px, 16);
+        const __m256 a = channelAvx2(px, 24);
+
+        const __m256 invA = _mm256_div_ps(one, a);
+        const __m256 maxC = _mm256_max_ps(r, _mm256_max_ps(g, b));
+        const __m256 minC = _mm256_min_ps(r, _mm256_min_ps(g, b));
+        const __m256 maxL = _mm256_min_ps(_mm256_mul_ps(maxC, invA), one);
+        const __m256 minL = _mm256_min_ps(_mm256_mul_ps(minC, invA), one);
+        __m256 l = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(maxL, minL), half),
+                                 lightness);
+        l = _mm256_min_ps(_mm256_max_ps(l, zero), one);
+        const __m256 lowL = _mm256_cmp_ps(l, half, _CMP_LE_OQ);
+        const __m256 invL = _mm256_sub_ps(one, l);
+        const __m256 aInfl = _mm256_mul_ps(a, infl);
+
+        const __m256 cs[3] = {r, g, b};
+        __m256i result = _mm256_slli_epi32(_mm256_srli_epi32(px, 24), 24);
+        for(int j = 0; j < 3; j++) {
+            const __m256 low = _mm256_mul_ps(l, _mm256_set1_ps(params.fLow[j]));
+            const __m256 high = _mm256_sub_ps(
+                        one, _mm256_mul_ps(invL, _mm256_set1_ps(params.fHigh[j])));
+            const __m256 ch = _mm256_blendv_ps(high, low, lowL);
+            const __m256 v = _mm256_add_ps(_mm256_mul_ps(ch, aInfl),
+                                           _mm256_mul_ps(cs[j], invInfl));
+            result = _mm256_or_si256(result, packChannelAvx2(v, 8*j));
+        }
+        const __m256i transparent = _mm256_cmpeq_epi32(
+                    _mm256_srli_epi32(px, 24), _mm256_setzero_si256());
+        result = _mm256_andnot_si256(transparent, result);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+TARGET_SSE41
+static int scaleSse41(const uchar* src, uchar* dst,
+                      const float* factors, const int count) {
+    const int n = count & ~3;
+    for(int i = 0; i < n; i += 4) {
+        const auto srcPx = reinterpret_cast<const __m128i*>(src + 4*i);
+        const __m128i px = _mm_loadu_si128(srcPx);
+        const __m128 f = _mm_loadu_ps(factors + i);
+        __m128i result = _mm_setzero_si128();
+        for(int shift = 0; shift < 32; shift += 8) {
+            const __m128 v = _mm_mul_ps(channelSse41(px, shift), f);
+            result = _mm_or_si128(result, packChannelSse41(v, shift));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+TARGET_AVX2
+static int scaleAvx2(const uchar* src, uchar* dst,
+                     const float* factors, const int count) {
+    const int n = count & ~7;
+    for(int i = 0; i < n; i += 8) {
+        const auto srcPx = reinterpret_cast<const __m256i*>(src + 4*i);
+        const __m256i px = _mm256_loadu_si256(srcPx);
+        const __m256 f = _mm256_loadu_ps(factors + i);
+        __m256i result = _mm256_setzero_si256();
+        for(int shift = 0; shift < 32; shift += 8) {
+            const __m256 v = _mm256_mul_ps(channelAvx2(px, shift), f);
+            result = _mm256_or_si256(result, packChannelAvx2(v, shift));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), result);
+    }
+    return n;
+}
+
+#endif // PIXELKERNELS_X86
+
+int PixelKernels::brightnessContrast(const uchar* src, uchar* dst,
+                                     const int count,
+                                     const float brightness,
+                                     const float contrast) {
+    // c*mul + a*alphaMul
+    const float mul = contrast + 1;
+    const float alphaMul = 0.5f + brightness - 0.5f*mul;
+#ifdef PIXELKERNELS_X86
+    switch(gIsa) {
+    case Isa::avx2:
+        return brightnessContrastAvx2(src, dst, count, mul, alphaMul);
+    case Isa::sse41:
+        return brightnessContrastSse41(src, dst, count, mul, alphaMul);
+    default: break;
+    }
+#else
+    Q_UNUSED(src)
+    Q_UNUSED(dst)
+    Q_UNUSED(count)
+    Q_UNUSED(alphaMul)
+#endif
+    return 0;
+}
+
+int PixelKernels::colorize(const uchar* src, uchar* dst, const int count,
+                           const ColorizeParams& params) {
+#ifdef PIXELKERNELS_X86
+    switch(gIsa) {
+    case Isa::avx2: return colorizeAvx2(src, dst, count, params);
+    case Isa::sse41: return colorizeSse41(src, dst, count, params);
+    default: break;
+    }
+#else
+    Q_UNUSED(src)
+    Q_UNUSED(dst)
+    Q_UNUSED(count)
+    Q_UNUSED(params)
+#endif
+    return 0;
+}
+
+int PixelKernels::scale(const uchar* src, uchar* dst,
+                        const float* factors, const int count) {
+#ifdef PIXELKERNELS_X86
+    switch(gIsa) {
+    case Isa::avx2: return scaleAvx2(src, dst, factors, count);
+    case Isa::sse41: return scaleSse41(src, dst, factors, count);
+    default: break;
+    }
+#else
+    Q_UNUSED(src)
+    Q_UNUSED(dst)
+    Q_UNUSED(factors)
+    Q_UNUSED(count)
+#endif
+    return 0;
+}
@@ -0,0 +1,66 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include "../core_global.h"
+
+//! @brief SIMD kernels for rows of premultiplied RGBA8888 pixels,
+//! the instruction set is selected at runtime.
+//! Each kernel returns the number of leading pixels it processed,
+//! the remaining ones are left for the scalar code of the caller.
+namespace PixelKernels {
+    enum class Isa { scalar, sse41, avx2 };
+
+    CORE_EXPORT
+    Isa isa();
+    //! @brief Best instruction set of the cpu.
+    CORE_EXPORT
+    Isa supportedIsa();
+    //! @brief Uses at most max from now on, for benchmarks and checks.
+    //! Call before any kernel runs.
+    CORE_EXPORT
+    void limitIsa(const Isa max);
+
+    //! @brief (c - a/2)*(contrast + 1) + a*(brightness + 1/2)
+    CORE_EXPORT
+    int brightnessContrast(const uchar* src, uchar* dst, const int count,
+                           const float brightness, const float contrast);
+
+    struct CORE_EXPORT ColorizeParams {
+        ColorizeParams(const qreal hue, const qreal saturation,
+                       const qreal lightness, const qreal influence);
+
+        float fLightness;
+        float fInfluence;
+        // channel = l*fLow for l <= 0.5, 1 - (1 - l)*fHigh above
+        float fLow[3];
+        float fHigh[3];
+    };
+
+    CORE_EXPORT
+    int colorize(const uchar* src, uchar* dst, const int count,
+                 const ColorizeParams& params);
+
+    //! @brief Multiplies all channels of each pixel by its factor.
+    CORE_EXPORT
+    int scale(const uchar* src, uchar* dst,
+              const float* factors, const int count);
+}
+
+#endif // PIXELKERNELS_H
@@ -46,6 +46,9 @@ public:
     virtual int cpuThreads(const int available, const int area) const;
 
     virtual bool srcDstSeparation() const { return true; }
+    //! @brief Each output pixel depends only on the input pixel
+    //! at the same position, consecutive such effects run fused on CPU.
+    virtual bool pointWise() const { return false; }
 
     HardwareSupport hardwareSupport() const {
         return fHwSupport;
@@ -17,6 +17,7 @@
 #include "wipeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "pixelkernels.h"
 
 #include "Animators/qrealanimator.h"
 
@@ -48,6 +49,7 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sSharpnessU = gl->glGetUniformLocation(sProgramId, "sharpness");
@@ -132,25 +134,28 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const qreal imgHeight = renderTools.fSrcBtmp.height();
 
     const int xMin = data.fTexTile.left();
-    const int xMax = data.fTexTile.right();
+    const int xMax = data.fTexTile.right() - 1;
     const int yMin = data.fTexTile.top();
-    const int yMax = data.fTexTile.bottom();
+    const int yMax = data.fTexTile.bottom() - 1;
 
     const qreal c = 0.25*PI - direction;
+    // a*cos(direction - asin(y/a)) with a = |(x, y)| is linear in x and y
+    const qreal div = cos(c) * sqrt(2);
+    const qreal fx = cos(direction)/div;
+    const qreal fy = sin(direction)/div;
 
+    const int width = xMax - xMin + 1;
+    std::vector<float> alphas(static_cast<size_t>(width));
     for(int yi = yMin; yi <= yMax; yi++) {
         auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
         auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
+        const qreal y = yi/imgHeight;
+        const qreal fRow = fy*y;
         for(int xi = xMin; xi <= xMax; xi++) {
             qreal x = xi/imgWidth;
-            const qreal y = yi/imgHeight;
-
             if(i) x = 1 - x;
 
-            const qreal a = sqrt(x*x + y*y);
-            const qreal b = direction - asin(y / a);
-
-            qreal f = a * cos(b) / (cos(c) * sqrt(2));
+            qreal f = fx*x + fRow;
 
             if(ii) f = 1 - f;
 
@@ -164,7 +169,14 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
             } else {
                 alpha = 1 - 0.5*(cos(PI*(f - x0)/(1 - mSharpness)) + 1);
             }
+            alphas[static_cast<size_t>(xi - xMin)] = alpha;
+        }
 
+        const int done = PixelKernels::scale(src, dst, alphas.data(), width);
+        src += 4*done;
+        dst += 4*done;
+        for(int xi = done; xi < width; xi++) {
+            const float alpha = alphas[static_cast<size_t>(xi)];
             for(int i = 0; i < 4; i++) {
                 *dst++ = *src++ * alpha;
             }
@@ -67,6 +67,45 @@ void eReadStream::readCheckpoint(const QString &errMsg) {
                      QString::number(pos) + "'.\n" + errMsg);
 }
 
+void eReadStream::skipToCheckpoint(const QString &errMsg) {
+    // checkpoints store their own position,
+    // look for the first qint64 that equals its offset
+    const qint64 size = mSrc->size();
+    for(qint64 sPos = mSrc->pos(); sPos + qint64(sizeof(qint64)) <= size; sPos++) {
+        if(!mSrc->seek(sPos)) break;
+        qint64 pos; read(&pos, sizeof(qint64));
+        if(pos == sPos) return;
+    }
+    RuntimeThrow("Could not find a checkpoint.\n" + errMsg);
+}
+
+qint64 eReadStream::readFrameBegin(const QString &errMsg) {
+    quint32 magic = 0;
+    if(read(&magic, sizeof(quint32)) != sizeof(quint32) ||
+       magic != EvFormat::frameMagic)
+        RuntimeThrow("Invalid frame header.\n" + errMsg);
+    qint64 len = -1;
+    read(&len, sizeof(qint64));
+    const qint64 endPos = mSrc->pos() + len;
+    if(len < 0 || endPos > mSrc->size())
+        RuntimeThrow("Invalid frame length '" + QString::number(len) +
+                     "'.\n" + errMsg);
+    return endPos;
+}
+
+void eReadStream::readFrameEnd(const qint64 endPos, const QString &errMsg) {
+    const qint64 pos = mSrc->pos();
+    if(pos != endPos)
+        RuntimeThrow("Frame ended at '" + QString::number(pos) +
+                     "' instead of '" + QString::number(endPos) + "'.\n" +
+                     errMsg);
+}
+
+void eReadStream::skipFrame(const QString &errMsg) {
+    const qint64 endPos = readFrameBegin(errMsg);
+    if(!mSrc->seek(endPos)) RuntimeThrow("Could not skip frame.\n" + errMsg);
+}
+
 QByteArray eReadStream::readCompressed() {
     QByteArray compressed; *this >> compressed;
     return qUncompress(compressed);
@@ -55,6 +55,16 @@ public:
     bool seek(const eFuturePos& pos);
 
     void readCheckpoint(const QString& errMsg);
+    //! @brief Skips data up to and including the next checkpoint,
+    //! used to omit sections that can not be parsed in the current context.
+    //! Payload can match a checkpoint by chance,
+    //! only for files written before frames.
+    void skipToCheckpoint(const QString& errMsg);
+
+    //! @brief Checks the frame header, returns the frame end position.
+    qint64 readFrameBegin(const QString& errMsg);
+    void readFrameEnd(const qint64 endPos, const QString& errMsg);
+    void skipFrame(const QString& errMsg);
 
     inline qint64 read(void* const data, const qint64 len) {
         return mSrc->read(reinterpret_cast<char*>(data), len);
@@ -27,11 +27,16 @@ namespace EvFormat {
         relativeFilePathSave = 21,
         flipBook = 22,
         colorizeInfluence = 23,
+        videoEncoderThreads = 24,
+        framedLayout = 25,
 
         nextVersion
     };
 
     const int version = nextVersion - 1;
+
+    //! @brief Marks the header of a length framed block, "eFRM"
+    const unsigned int frameMagic = 0x4d524665;
 }
 
 #endif // EVFORMAT_H
@@ -5,6 +5,7 @@
 #include "Paint/brushescontext.h"
 #include "filefooter.h"
 #include "framerange.h"
+#include "evformat.h"
 
 void eWriteFutureTable::write(eWriteStream &dst) {
     for(const auto& future : mFutures) {
@@ -36,6 +37,23 @@ void eWriteStream::writeCheckpoint() {
     write(&pos, sizeof(qint64));
 }
 
+qint64 eWriteStream::beginFrame() {
+    const quint32 magic = EvFormat::frameMagic;
+    write(&magic, sizeof(quint32));
+    const qint64 framePos = mDst->pos();
+    const qint64 len = 0;
+    write(&len, sizeof(qint64));
+    return framePos;
+}
+
+void eWriteStream::endFrame(const qint64 framePos) {
+    const qint64 endPos = mDst->pos();
+    const qint64 len = endPos - framePos - qint64(sizeof(qint64));
+    if(!mDst->seek(framePos)) RuntimeThrow("Could not write frame length");
+    write(&len, sizeof(qint64));
+    mDst->seek(endPos);
+}
+
 qint64 eWriteStream::writeFile(QFile * const file) {
     if(!file) RuntimeThrow("No file to write");
     const bool openRes = file->open(QIODevice::ReadOnly);
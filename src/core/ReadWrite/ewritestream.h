@@ -57,6 +57,11 @@ public:
 
     void writeCheckpoint();
 
+    //! @brief Starts a block with a magic and length header,
+    //! returns the position to be passed to endFrame.
+    qint64 beginFrame();
+    void endFrame(const qint64 framePos);
+
     qint64 writeFile(QFile* const file);
 
     inline qint64 write(const void* const data, const qint64 len) {
@@ -0,0 +1,234 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "mixkernels.h"
+
+#include <cmath>
+#include <limits>
+
+#include "exceptions.h"
+#include "RasterEffects/pixelkernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define MIXKERNELS_AVX
+    #define TARGET_AVX __attribute__((target("avx")))
+    #include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+    #define MIXKERNELS_AVX
+    #define TARGET_AVX
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+#ifdef MIXKERNELS_AVX
+TARGET_AVX
+static int mixRampAvx(float * const dst, const float * const src, const int n,
+                      const float gain, const float gainStep) {
+    const __m256 step = _mm256_set1_ps(8*gainStep);
+    __m256 g = _mm256_setr_ps(gain, gain + gainStep,
+                              gain + 2*gainStep, gain + 3*gainStep,
+                              gain + 4*gainStep, gain + 5*gainStep,
+                              gain + 6*gainStep, gain + 7*gainStep);
+    int i = 0;
+    for(; i + 8 <= n; i += 8) {
+        const __m256 d = _mm256_loadu_ps(dst + i);
+        const __m256 s = _mm256_loadu_ps(src + i);
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, g)));
+        g = _mm256_add_ps(g, step);
+    }
+    return i;
+}
+#endif
+
+void MixKernels::mixRamp(float * const dst, const float * const src,
+                         const int n, const float gain, const float gainStep) {
+    int i = 0;
+#ifdef MIXKERNELS_AVX
+    // every cpu with avx2 has avx
+    if(PixelKernels::isa() == PixelKernels::Isa::avx2) {
+        i = mixRampAvx(dst, src, n, gain, gainStep);
+    }
+#endif
+#if defined(__SSE__) || defined(_M_X64)
+    // sse is part of the x86-64 baseline
+    const __m128 step = _mm_set1_ps(4*gainStep);
+    __m128 g = _mm_setr_ps(gain + i*gainStep, gain + (i + 1)*gainStep,
+                           gain + (i + 2)*gainStep, gain + (i + 3)*gainStep);
+    for(; i + 4 <= n; i += 4) {
+        const __m128 d = _mm_loadu_ps(dst + i);
+        const __m128 s = _mm_loadu_ps(src + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, g)));
+        g = _mm_add_ps(g, step);
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t step = vdupq_n_f32(4*gainStep);
+    const float gInit[4] = {gain, gain + gainStep,
+                            gain + 2*gainStep, gain + 3*gainStep};
+    float32x4_t g = vld1q_f32(gInit);
+    for(; i + 4 <= n; i += 4) {
+        const float32x4_t d = vld1q_f32(dst + i);
+        const float32x4_t s = vld1q_f32(src + i);
+        vst1q_f32(dst + i, vmlaq_f32(d, s, g));
+        g = vaddq_f32(g, step);
+    }
+#endif
+    for(; i < n; i++) dst[i] += src[i]*(gain + i*gainStep);
+}
+
+template <typename T>
+void readPlanar(uchar const * const * const src, const int srcFirst,
+                float * const * const dst, const int nSamples,
+                const int nChannels, const float scale, const float shift) {
+    for(int j = 0; j < nChannels; j++) {
+        const T* const srcJ = reinterpret_cast<const T*>(src[j]) + srcFirst;
+        float* const dstJ = dst[j];
+        for(int i = 0; i < nSamples; i++)
+            dstJ[i] = (static_cast<float>(srcJ[i]) - shift)*scale;
+    }
+}
+
+template <typename T>
+void readInterleaved(uchar const * const * const src, const int srcFirst,
+                     float * const * const dst, const int nSamples,
+                     const int nChannels, const float scale, const float shift) {
+    const T* srcI = reinterpret_cast<const T*>(src[0]) + srcFirst*nChannels;
+    for(int i = 0; i < nSamples; i++) {
+        for(int j = 0; j < nChannels; j++)
+            dst[j][i] = (static_cast<float>(*srcI++) - shift)*scale;
+    }
+}
+
+void MixKernels::readToFloat(uchar const * const * const src,
+                             const int srcFirst,
+                             float * const * const dst, const int nSamples,
+                             const AVSampleFormat format,
+                             const int nChannels) {
+    const float s16 = 1.f/32768;
+    const float s32 = 1.f/2147483648.f;
+    const float s64 = 1.f/9223372036854775808.f;
+    switch(format) {
+    case AV_SAMPLE_FMT_FLT:
+        return readInterleaved<float>(src, srcFirst, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_FLTP:
+        return readPlanar<float>(src, srcFirst, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_DBL:
+        return readInterleaved<qreal>(src, srcFirst, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_DBLP:
+        return readPlanar<qreal>(src, srcFirst, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_U8:
+        return readInterleaved<quint8>(src, srcFirst, dst, nSamples, nChannels, 1.f/128, 128);
+    case AV_SAMPLE_FMT_U8P:
+        return readPlanar<quint8>(src, srcFirst, dst, nSamples, nChannels, 1.f/128, 128);
+    case AV_SAMPLE_FMT_S16:
+        return readInterleaved<qint16>(src, srcFirst, dst, nSamples, nChannels, s16, 0);
+    case AV_SAMPLE_FMT_S16P:
+        return readPlanar<qint16>(src, srcFirst, dst, nSamples, nChannels, s16, 0);
+    case AV_SAMPLE_FMT_S32:
+        return readInterleaved<qint32>(src, srcFirst, dst, nSamples, nChannels, s32, 0);
+    case AV_SAMPLE_FMT_S32P:
+        return readPlanar<qint32>(src, srcFirst, dst, nSamples, nChannels, s32, 0);
+    case AV_SAMPLE_FMT_S64:
+        return readInterleaved<qint64>(src, srcFirst, dst, nSamples, nChannels, s64, 0);
+    case AV_SAMPLE_FMT_S64P:
+        return readPlanar<qint64>(src, srcFirst, dst, nSamples, nChannels, s64, 0);
+    default: RuntimeThrow("Unsupported format " + av_get_sample_fmt_name(format));
+    }
+}
+
+template <typename T>
+T fromFloat(const float value, const double scale, const double shift) {
+    const double min = std::numeric_limits<T>::min();
+    const double max = std::numeric_limits<T>::max();
+    const double result = std::round(value*scale + shift);
+    if(result <= min) return std::numeric_limits<T>::min();
+    if(result >= max) return std::numeric_limits<T>::max();
+    return static_cast<T>(result);
+}
+
+template <>
+float fromFloat<float>(const float value, const double scale, const double shift) {
+    Q_UNUSED(scale)
+    Q_UNUSED(shift)
+    return value;
+}
+
+template <>
+qreal fromFloat<qreal>(const float value, const double scale, const double shift) {
+    Q_UNUSED(scale)
+    Q_UNUSED(shift)
+    return static_cast<qreal>(value);
+}
+
+template <typename T>
+void writePlanar(float const * const * const src, uchar ** const dst,
+                 const int nSamples, const int nChannels,
+                 const double scale, const double shift) {
+    for(int j = 0; j < nChannels; j++) {
+        const float* const srcJ = src[j];
+        T* const dstJ = reinterpret_cast<T*>(dst[j]);
+        for(int i = 0; i < nSamples; i++)
+            dstJ[i] = fromFloat<T>(srcJ[i], scale, shift);
+    }
+}
+
+template <typename T>
+void writeInterleaved(float const * const * const src, uchar ** const dst,
+                      const int nSamples, const int nChannels,
+                      const double scale, const double shift) {
+    T* dstI = reinterpret_cast<T*>(dst[0]);
+    for(int i = 0; i < nSamples; i++) {
+        for(int j = 0; j < nChannels; j++)
+            *dstI++ = fromFloat<T>(src[j][i], scale, shift);
+    }
+}
+
+void MixKernels::writeFromFloat(float const * const * const src,
+                                uchar ** const dst,
+                                const int nSamples,
+                                const AVSampleFormat format,
+                                const int nChannels) {
+    const double s16 = 32768;
+    const double s32 = 2147483648.;
+    const double s64 = 9223372036854775808.;
+    switch(format) {
+    case AV_SAMPLE_FMT_FLT:
+        return writeInterleaved<float>(src, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_FLTP:
+        return writePlanar<float>(src, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_DBL:
+        return writeInterleaved<qreal>(src, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_DBLP:
+        return writePlanar<qreal>(src, dst, nSamples, nChannels, 1, 0);
+    case AV_SAMPLE_FMT_U8:
+        return writeInterleaved<quint8>(src, dst, nSamples, nChannels, 128, 128);
+    case AV_SAMPLE_FMT_U8P:
+        return writePlanar<quint8>(src, dst, nSamples, nChannels, 128, 128);
+    case AV_SAMPLE_FMT_S16:
+        return writeInterleaved<qint16>(src, dst, nSamples, nChannels, s16, 0);
+    case AV_SAMPLE_FMT_S16P:
+        return writePlanar<qint16>(src, dst, nSamples, nChannels, s16, 0);
+    case AV_SAMPLE_FMT_S32:
+        return writeInterleaved<qint32>(src, dst, nSamples, nChannels, s32, 0);
+    case AV_SAMPLE_FMT_S32P:
+        return writePlanar<qint32>(src, dst, nSamples, nChannels, s32, 0);
+    case AV_SAMPLE_FMT_S64:
+        return writeInterleaved<qint64>(src, dst, nSamples, nChannels, s64, 0);
+    case AV_SAMPLE_FMT_S64P:
+        return writePlanar<qint64>(src, dst, nSamples, nChannels, s64, 0);
+    default: RuntimeThrow("Unsupported format " + av_get_sample_fmt_name(format));
+    }
+}
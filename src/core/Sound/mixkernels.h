@@ -0,0 +1,47 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MIXKERNELS_H
+#define MIXKERNELS_H
+
+#include "../core_global.h"
+extern "C" {
+    #include <libavutil/samplefmt.h>
+}
+
+//! @brief Sample conversion and mixing for the planar float mix bus
+//! of SoundMerger, the instruction set is selected at runtime.
+namespace MixKernels {
+    //! @brief dst[i] += src[i]*(gain + i*gainStep)
+    CORE_EXPORT
+    void mixRamp(float * const dst, const float * const src, const int n,
+                 const float gain, const float gainStep);
+
+    //! @brief Converts samples to planar float,
+    //! integers are normalized to [-1, 1].
+    CORE_EXPORT
+    void readToFloat(uchar const * const * const src, const int srcFirst,
+                     float * const * const dst, const int nSamples,
+                     const AVSampleFormat format, const int nChannels);
+
+    //! @brief Converts planar float to the output format, clipping once.
+    CORE_EXPORT
+    void writeFromFloat(float const * const * const src, uchar ** const dst,
+                        const int nSamples, const AVSampleFormat format,
+                        const int nChannels);
+}
+
+#endif // MIXKERNELS_H
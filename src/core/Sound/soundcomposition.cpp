@@ -20,6 +20,7 @@
 #include "CacheHandlers/soundcachecontainer.h"
 #include "soundmerger.h"
 #include "FileCacheHandlers/soundreader.h"
+#include "Private/esettings.h"
 
 SoundComposition::SoundComposition(Canvas * const parent) :
     QIODevice(parent), mParent(parent) {
@@ -33,6 +34,7 @@ SoundComposition::SoundComposition(Canvas * const parent) :
 void SoundComposition::start(const int startFrame) {
     mPos = qRound(startFrame*mSettings.fSampleRate/mParent->getFps());
     open(QIODevice::ReadOnly);
+    scheduleLookAhead();
 }
 
 void SoundComposition::stop() {
@@ -131,13 +133,26 @@ SoundMerger *SoundComposition::scheduleSecond(const int secondId) {
     return task.get();
 }
 
+void SoundComposition::scheduleLookAhead() {
+    const int lookAhead = eSettings::sInstance->fAudioLookAheadSeconds;
+    if(lookAhead <= 0) return;
+    const int firstSec = currentSecond();
+    const int lastSec = qMin(firstSec + lookAhead,
+                             qFloor(mParent->getMaxFrame()/mParent->getFps()));
+    for(int i = firstSec; i <= lastSec; i++) scheduleSecond(i);
+}
+
+int SoundComposition::currentSecond() const {
+    const int sampleRate = mSettings.fSampleRate;
+    return static_cast<int>(mPos/sampleRate + (mPos >= 0 ? 0 : -1));
+}
+
 void SoundComposition::frameRangeChanged(const FrameRange &range) {
     const qreal fps = mParent->getFps();
     secondRangeChanged({qFloor(range.fMin/fps), qCeil(range.fMax/fps)});
 }
 
 qint64 SoundComposition::readData(char *data, qint64 maxLen) {
-    const int sampleRate = mSettings.fSampleRate;
     const int bytesPerSample = mSettings.bytesPerSample();
     const int nChannels = mSettings.channelCount();
     const int bytesPerSampleFrame = nChannels * bytesPerSample;
@@ -146,7 +161,7 @@ qint64 SoundComposition::readData(char *data, qint64 maxLen) {
     const SampleRange readSamples{static_cast<int>(mPos),
                                   static_cast<int>(mPos + maxLen/bytesPerSampleFrame)};
     while(maxLen > total) {
-        const int secondId = static_cast<int>(mPos/sampleRate + (mPos >= 0 ? 0 : -1));
+        const int secondId = currentSecond();
         const auto cont = mSecondsCache.atFrame<SoundCacheContainer>(secondId);
         if(!cont) break;
         const auto samples = cont->getSamples();
@@ -162,6 +177,7 @@ qint64 SoundComposition::readData(char *data, qint64 maxLen) {
         mPos += nSamples;
         total += chunk;
     }
+    scheduleLookAhead();
 
     return total;
 }
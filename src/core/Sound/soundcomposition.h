@@ -67,6 +67,10 @@ public:
     bool hasAnySounds() const { return !mSounds.isEmpty(); }
 private:
     SoundMerger * scheduleSecond(const int secondId);
+    //! @brief Schedules the seconds within the look-ahead window
+    //! following the playback position.
+    void scheduleLookAhead();
+    int currentSecond() const;
 
     void frameRangeChanged(const FrameRange &range);
 
@@ -15,239 +15,34 @@
 // along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "soundmerger.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "mixkernels.h"
 
-template <typename T>
-void mergePlanarDataUnsigned(T const * const * const src,
-                             const SampleRange& srcRange,
-                             T ** const dst,
-                             const SampleRange& dstRange,
-                             const int nSamples,
-                             QrealSnapshot::Iterator volIt,
-                             const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    const qreal shift = max/2;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[j][dstId];
-                dstP = T(qBound(min, round(dstP + (src[j][srcId] - shift)*vol + shift), max));
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[j][dstId];
-                dstP = T(qBound(min, round(dstP + (src[j][srcId] - shift)*vol + shift), max));
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-template <typename T>
-void mergeInterleavedDataUnsigned(const T* const src,
-                                  const SampleRange& srcRange,
-                                  T * const dst,
-                                  const SampleRange& dstRange,
-                                  const int nSamples,
-                                  QrealSnapshot::Iterator volIt,
-                                  const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    const qreal shift = max/2;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + (src[srcId++] - shift)*vol + shift), max));
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + (src[srcId++] - shift)*vol + shift), max));
-            }
-        }
-    }
-}
-
-template <typename T>
-void mergePlanarDataSigned(T const * const * const src,
-                           const SampleRange& srcRange,
-                           T ** const dst,
-                           const SampleRange& dstRange,
-                           const int nSamples,
-                           QrealSnapshot::Iterator volIt,
-                           const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] = T(qBound(min, round(dst[j][dstId] + src[j][srcId]*vol), max));
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] = T(qBound(min, round(dst[j][dstId] + src[j][srcId]*vol), max));
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-template <typename T>
-void mergeInterleavedDataSigned(const T* const src,
-                                const SampleRange& srcRange,
-                                T * const dst,
-                                const SampleRange& dstRange,
-                                const int nSamples,
-                                QrealSnapshot::Iterator volIt,
-                                const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    const qreal min = std::numeric_limits<T>::min();
-    const qreal max = std::numeric_limits<T>::max();
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                auto& dstP = dst[dstId++];
-                dstP = T(qBound(min, round(dstP + src[srcId++]*vol), max));
-            }
-        }
-    }
-}
-
-void mergePlanarData(float const * const * const src,
-                     const SampleRange& srcRange,
-                     float ** const dst,
-                     const SampleRange& dstRange,
-                     const int nSamples,
-                     QrealSnapshot::Iterator volIt,
-                     const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
-    if(volIt.staticValue()) {
-        const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-void mergeInterleavedData(const float* const src,
-                          const SampleRange& srcRange,
-                          float * const dst,
-                          const SampleRange& dstRange,
-                          const int nSamples,
-                          QrealSnapshot::Iterator volIt,
-                          const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    if(volIt.staticValue()) {
-        const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const float vol = static_cast<float>(volIt.getValueAndProgress(1));
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    }
-}
+#include <QVector>
+#include <QVarLengthArray>
 
+// animated volume is ramped linearly between values this many samples apart
+const int sRampLength = 64;
 
-void mergePlanarData(qreal const * const * const src,
-                     const SampleRange& srcRange,
-                     qreal ** const dst,
-                     const SampleRange& dstRange,
-                     const int nSamples,
-                     QrealSnapshot::Iterator volIt,
-                     const int nChannels) {
-    int dstId = dstRange.fMin;
-    int srcId = srcRange.fMin;
+void mixChannels(float * const * const bus,
+                 float const * const * const src,
+                 const int nSamples,
+                 QrealSnapshot::Iterator& volIt,
+                 const int nChannels) {
     if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
+        const float gain = static_cast<float>(volIt.getValueAndProgress(1));
+        for(int j = 0; j < nChannels; j++)
+            MixKernels::mixRamp(bus[j], src[j], nSamples, gain, 0);
     } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
+        for(int i = 0; i < nSamples; i += sRampLength) {
+            const int len = qMin(sRampLength, nSamples - i);
+            const qreal gain0 = volIt.getValueAndProgress(len);
+            const qreal gain1 = volIt.getValueAndProgress(-1);
+            const float gain = static_cast<float>(gain0);
+            const float gainStep = static_cast<float>((gain1 - gain0)/len);
             for(int j = 0; j < nChannels; j++) {
-                dst[j][dstId] += src[j][srcId]*vol;
-            }
-            dstId++; srcId++;
-        }
-    }
-}
-
-void mergeInterleavedData(const qreal* const src,
-                          const SampleRange& srcRange,
-                          qreal * const dst,
-                          const SampleRange& dstRange,
-                          const int nSamples,
-                          QrealSnapshot::Iterator volIt,
-                          const int nChannels) {
-    int dstId = dstRange.fMin*nChannels;
-    int srcId = srcRange.fMin*nChannels;
-    if(volIt.staticValue()) {
-        const qreal vol = volIt.getValueAndProgress(1);
-        for(int i = 0; i < nSamples; i++) {
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
-            }
-        }
-    } else {
-        for(int i = 0; i < nSamples; i++) {
-            const qreal vol = volIt.getValueAndProgress(1);
-            for(int j = 0; j < nChannels; j++) {
-                dst[dstId++] += src[srcId++]*vol;
+                MixKernels::mixRamp(bus[j] + i, src[j] + i,
+                                    len, gain, gainStep);
             }
         }
     }
@@ -255,62 +50,37 @@ void mergeInterleavedData(const qreal* const src,
 
 void mergeData(uchar const * const * const src,
                const SampleRange& srcRange,
-               uchar ** const dst,
+               float * const * const bus,
                const SampleRange& dstRange,
                int nSamples,
                QrealSnapshot::Iterator volIt,
                const AVSampleFormat format,
-               const int nChannels) {
+               const int nChannels,
+               QVector<float>& scratch) {
     nSamples = qMin(qMin(nSamples, dstRange.span()), srcRange.span());
-    if(format == AV_SAMPLE_FMT_FLT) {
-        mergeInterleavedData(reinterpret_cast<const float*>(src[0]), srcRange,
-                             reinterpret_cast<float*>(dst[0]), dstRange,
-                             nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_FLTP) {
-        mergePlanarData(reinterpret_cast<float const * const *>(src), srcRange,
-                        reinterpret_cast<float**>(dst), dstRange,
-                        nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_DBL) {
-        mergeInterleavedData(reinterpret_cast<const qreal*>(src[0]), srcRange,
-                             reinterpret_cast<qreal*>(dst[0]), dstRange,
-                             nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_DBLP) {
-        mergePlanarData(reinterpret_cast<qreal const * const *>(src), srcRange,
-                        reinterpret_cast<qreal**>(dst), dstRange,
-                        nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_U8) {
-        mergeInterleavedDataUnsigned(reinterpret_cast<const quint8*>(src[0]), srcRange,
-                                     reinterpret_cast<quint8*>(dst[0]), dstRange,
-                                     nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_U8P) {
-        mergePlanarDataUnsigned(reinterpret_cast<quint8 const * const *>(src), srcRange,
-                                reinterpret_cast<quint8**>(dst), dstRange,
-                                nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S16) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint16*>(src[0]), srcRange,
-                                   reinterpret_cast<qint16*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S16P) {
-        mergePlanarDataSigned(reinterpret_cast<qint16 const * const *>(src), srcRange,
-                              reinterpret_cast<qint16**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S32) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint32*>(src[0]), srcRange,
-                                   reinterpret_cast<qint32*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S32P) {
-        mergePlanarDataSigned(reinterpret_cast<qint32 const * const *>(src), srcRange,
-                              reinterpret_cast<qint32**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S64) {
-        mergeInterleavedDataSigned(reinterpret_cast<const qint64*>(src[0]), srcRange,
-                                   reinterpret_cast<qint64*>(dst[0]), dstRange,
-                                   nSamples, volIt, nChannels);
-    } else if(format == AV_SAMPLE_FMT_S64P) {
-        mergePlanarDataSigned(reinterpret_cast<qint64 const * const *>(src), srcRange,
-                              reinterpret_cast<qint64**>(dst), dstRange,
-                              nSamples, volIt, nChannels);
-    } else RuntimeThrow("Unsupported format " + av_get_sample_fmt_name(format));
+    if(nSamples <= 0) return;
+    QVarLengthArray<const float*, 8> srcF(nChannels);
+    QVarLengthArray<float*, 8> busF(nChannels);
+    if(format == AV_SAMPLE_FMT_FLTP) {
+        for(int j = 0; j < nChannels; j++) {
+            srcF[j] = reinterpret_cast<const float*>(src[j]) + srcRange.fMin;
+        }
+    } else {
+        scratch.resize(nSamples*nChannels);
+        QVarLengthArray<float*, 8> scratchF(nChannels);
+        for(int j = 0; j < nChannels; j++) {
+            scratchF[j] = scratch.data() + j*nSamples;
+            srcF[j] = scratchF[j];
+        }
+        MixKernels::readToFloat(src, srcRange.fMin, scratchF.data(),
+                                nSamples, format, nChannels);
+    }
+    for(int j = 0; j < nChannels; j++) busF[j] = bus[j] + dstRange.fMin;
+    mixChannels(busF.data(), srcF.data(), nSamples, volIt, nChannels);
+}
+
+void SoundMerger::queTaskNow() {
+    TaskScheduler::instance()->queHddTask(ref<eTask>(), TaskPriority::audio);
 }
 
 void SoundMerger::process() {
@@ -319,8 +89,12 @@ void SoundMerger::process() {
                                           mSettings.fSampleRate,
                                           mSettings.fSampleFormat,
                                           mSettings.fChannelLayout);
-    mSamples->zeroAll();
-    const auto dst = mSamples->fData;
+    // sounds are summed on a planar float bus, converted to the output once
+    const int busLength = mSampleRange.span();
+    QVector<float> busData(busLength*nChannels, 0.f);
+    QVarLengthArray<float*, 8> bus(nChannels);
+    for(int j = 0; j < nChannels; j++) bus[j] = busData.data() + j*busLength;
+    QVector<float> scratch;
     for(const auto& sound : mSounds) {
         const auto srcSamples = sound.fSamples;
         const qreal stretch = sound.fStretch;
@@ -346,8 +120,9 @@ void SoundMerger::process() {
             const int nSamples = qMin(srcNeededRelRange.span(), dstRelRange.span());
 
             const auto src = srcSamples->fData;
-            mergeData(src, srcNeededRelRange, dst, dstRelRange,
-                      nSamples, volIt, mSettings.fSampleFormat, nChannels);
+            mergeData(src, srcNeededRelRange, bus.data(), dstRelRange,
+                      nSamples, volIt, mSettings.fSampleFormat, nChannels,
+                      scratch);
         } else {
             const int srcSampleRate = mSettings.fSampleRate;
             const int dstSampleRate = qRound(mSettings.fSampleRate*stretch);
@@ -379,10 +154,13 @@ void SoundMerger::process() {
                                 srcSampleRate);
             swr_free(&swrContext);
             if(nSamples < 0) RuntimeThrow("Resampling failed");
-            mergeData(buffer, srcNeededRelRange, dst, dstRelRange,
-                      nSamples, volIt, mSettings.fSampleFormat, nChannels);
+            mergeData(buffer, srcNeededRelRange, bus.data(), dstRelRange,
+                      nSamples, volIt, mSettings.fSampleFormat, nChannels,
+                      scratch);
             if(buffer) av_freep(&buffer[0]);
             av_freep(&buffer);
         }
     }
+    MixKernels::writeFromFloat(bus.data(), mSamples->fData, busLength,
+                   mSettings.fSampleFormat, nChannels);
 }
@@ -33,7 +33,7 @@ struct CORE_EXPORT SingleSoundData {
     stdsptr<Samples> fSamples;
 };
 
-class CORE_EXPORT SoundMerger : public eCpuTask {
+class CORE_EXPORT SoundMerger : public eHddTask {
     e_OBJECT
 protected:
     SoundMerger(const int secondId, const SampleRange& sampleRange,
@@ -47,6 +47,13 @@ protected:
         if(mComposition)
             mComposition->secondFinished(mSecondId, mSamples);
     }
+
+    void afterCanceled() {
+        if(mComposition)
+            mComposition->secondFinished(mSecondId, nullptr);
+    }
+
+    void queTaskNow();
 public:
     void process();
 
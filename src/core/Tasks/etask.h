@@ -45,6 +45,12 @@ public:
     bool queTask();
 
     void aboutToProcess(const Hardware hw);
+
+    //! @brief Time spent processing, summed over all the steps.
+    qint64 processingTimeUs() const { return mProcessingTimeUs; }
+    void addProcessingTime(const qint64 us) { mProcessingTimeUs += us; }
+private:
+    qint64 mProcessingTimeUs = 0;
 };
 
 Q_DECLARE_METATYPE(stdsptr<eTask>);
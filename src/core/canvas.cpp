@@ -420,6 +420,7 @@ void Canvas::setOutputRendering(const bool bT) {
 void Canvas::setSceneFrame(const int relFrame) {
     const auto cont = mSceneFramesHandler.atFrame(relFrame);
     setSceneFrame(enve::shared<SceneFrameContainer>(cont));
+    prefetchSceneFrames(relFrame);
 }
 
 void Canvas::setSceneFrame(const stdsptr<SceneFrameContainer>& cont) {
@@ -437,6 +438,25 @@ void Canvas::setLoadingSceneFrame(const stdsptr<SceneFrameContainer>& cont) {
     }
 }
 
+void Canvas::sceneFrameLoaded(SceneFrameContainer * const cont) {
+    if(mLoadingSceneFrame.get() != cont) return;
+    setSceneFrame(cont->ref<SceneFrameContainer>());
+}
+
+void Canvas::prefetchSceneFrames(const int relFrame) {
+    const int nFrames = 4;
+    int frame = relFrame + 1;
+    for(int i = 0; i < nFrames; i++) {
+        const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(frame);
+        if(!cont) {
+            frame++;
+            continue;
+        }
+        if(!cont->storesDataInMemory()) cont->scheduleLoadFromTmpFile();
+        frame = cont->getRange().fMax + 1;
+    }
+}
+
 FrameRange Canvas::prp_getIdenticalRelRange(const int relFrame) const {
     const auto groupRange = ContainerBox::prp_getIdenticalRelRange(relFrame);
     //FrameRange canvasRange{0, mMaxFrame};
@@ -449,6 +469,8 @@ void Canvas::renderDataFinished(BoxRenderData *renderData) {
     else if(renderData->fBoxStateId < mLastStateId) return;
     const int relFrame = qRound(renderData->fRelFrame);
     mLastStateId = renderData->fBoxStateId;
+    ContainerBoxRenderData::sFramePixelsComposited =
+            renderData->totalPixelsComposited();
 
     const auto range = prp_getIdenticalRelRange(relFrame);
     const auto cont = enve::make_shared<SceneFrameContainer>(
@@ -708,6 +730,7 @@ void Canvas::anim_setAbsFrame(const int frame) {
         mSceneFrameOutdated = true;
         planUpdate(UpdateReason::frameChange);
     }
+    prefetchSceneFrames(newRelFrame);
 
     mUndoRedoStack->setFrame(frame);
 
@@ -402,9 +402,14 @@ public:
     void setSceneFrame(const int relFrame);
     void setSceneFrame(const stdsptr<SceneFrameContainer> &cont);
     void setLoadingSceneFrame(const stdsptr<SceneFrameContainer> &cont);
+    void sceneFrameLoaded(SceneFrameContainer * const cont);
+    //! @brief Loads the frames following relFrame back from the drive.
+    void prefetchSceneFrames(const int relFrame);
 
     void setRenderingPreview(const bool bT);
 
+    bool isRenderingOutput() const { return mRenderingOutput; }
+
     bool isPreviewingOrRendering() const {
         return mPreviewing || mRenderingPreview || mRenderingOutput;
     }
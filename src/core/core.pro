@@ -107,6 +107,7 @@ SOURCES += \
     Boxes/textbox.cpp \
     Boxes/textboxrenderdata.cpp \
     Boxes/videobox.cpp \
+    CacheHandlers/cachearena.cpp \
     CacheHandlers/cachecontainer.cpp \
     CacheHandlers/hddcachablecachehandler.cpp \
     CacheHandlers/hddcachablecont.cpp \
@@ -118,7 +119,6 @@ SOURCES += \
     CacheHandlers/soundcachecontainer.cpp \
     CacheHandlers/soundcachehandler.cpp \
     CacheHandlers/soundtmpfilehandlers.cpp \
-    CacheHandlers/tmpdeleter.cpp \
     CacheHandlers/tmploader.cpp \
     CacheHandlers/tmpsaver.cpp \
     CacheHandlers/usedrange.cpp \
@@ -137,6 +137,9 @@ SOURCES += \
     FileCacheHandlers/videocachehandler.cpp \
     FileCacheHandlers/videoframeloader.cpp \
     FileCacheHandlers/videostreamsdata.cpp \
+    FileCacheHandlers/videoframeindex.cpp \
+    FileCacheHandlers/videorangeloader.cpp \
+    FileCacheHandlers/proxymedia.cpp \
     GUI/boxeslistactionbutton.cpp \
     GUI/coloranimatorbutton.cpp \
     GUI/dialogsinterface.cpp \
@@ -182,6 +185,7 @@ SOURCES += \
     PathEffects/sumpatheffect.cpp \
     PathEffects/zigzagpatheffect.cpp \
     Private/Tasks/complextask.cpp \
+    Private/Tasks/cputaskpool.cpp \
     Private/Tasks/execcontroller.cpp \
     Private/Tasks/gputaskexecutor.cpp \
     Private/Tasks/offscreenqgl33c.cpp \
@@ -209,6 +213,7 @@ SOURCES += \
     RasterEffects/noisefadeeffect.cpp \
     RasterEffects/oileffect.cpp \
     RasterEffects/openglrastereffectcaller.cpp \
+    RasterEffects/pixelkernels.cpp \
     RasterEffects/rastereffect.cpp \
     RasterEffects/rastereffectcaller.cpp \
     RasterEffects/rastereffectcollection.cpp \
@@ -233,6 +238,7 @@ SOURCES += \
     Sound/esoundlink.cpp \
     Sound/esoundobjectbase.cpp \
     Sound/esoundsettings.cpp \
+    Sound/mixkernels.cpp \
     Sound/evideosound.cpp \
     Sound/soundcomposition.cpp \
     Sound/soundmerger.cpp \
@@ -321,6 +327,7 @@ SOURCES += \
     Animators/steppedanimator.cpp \
     differsinterpolate.cpp \
     skia/skiahelpers.cpp \
+    skia/pixelbufferpool.cpp \
     Animators/keyt.cpp \
     Animators/basedkeyt.cpp \
     Animators/graphkeyt.cpp \
@@ -422,6 +429,7 @@ HEADERS += \
     Boxes/textbox.h \
     Boxes/textboxrenderdata.h \
     Boxes/videobox.h \
+    CacheHandlers/cachearena.h \
     CacheHandlers/cachecontainer.h \
     CacheHandlers/hddcachablecachehandler.h \
     CacheHandlers/hddcachablecont.h \
@@ -433,7 +441,6 @@ HEADERS += \
     CacheHandlers/soundcachecontainer.h \
     CacheHandlers/soundcachehandler.h \
     CacheHandlers/soundtmpfilehandlers.h \
-    CacheHandlers/tmpdeleter.h \
     CacheHandlers/tmploader.h \
     CacheHandlers/tmpsaver.h \
     CacheHandlers/usedrange.h \
@@ -453,6 +460,9 @@ HEADERS += \
     FileCacheHandlers/videocachehandler.h \
     FileCacheHandlers/videoframeloader.h \
     FileCacheHandlers/videostreamsdata.h \
+    FileCacheHandlers/videoframeindex.h \
+    FileCacheHandlers/videorangeloader.h \
+    FileCacheHandlers/proxymedia.h \
     GUI/boxeslistactionbutton.h \
     GUI/coloranimatorbutton.h \
     GUI/dialogsinterface.h \
@@ -501,6 +511,7 @@ HEADERS += \
     PathEffects/sumpatheffect.h \
     PathEffects/zigzagpatheffect.h \
     Private/Tasks/complextask.h \
+    Private/Tasks/cputaskpool.h \
     Private/Tasks/execcontroller.h \
     Private/Tasks/gputaskexecutor.h \
     Private/Tasks/offscreenqgl33c.h \
@@ -531,6 +542,7 @@ HEADERS += \
     RasterEffects/noisefadeeffect.h \
     RasterEffects/oileffect.h \
     RasterEffects/openglrastereffectcaller.h \
+    RasterEffects/pixelkernels.h \
     RasterEffects/rastereffect.h \
     RasterEffects/customrastereffectcreator.h \
     RasterEffects/rastereffectcaller.h \
@@ -565,6 +577,7 @@ HEADERS += \
     Sound/esoundlink.h \
     Sound/esoundobjectbase.h \
     Sound/esoundsettings.h \
+    Sound/mixkernels.h \
     Sound/evideosound.h \
     Sound/soundcomposition.h \
     Sound/soundmerger.h \
@@ -662,6 +675,7 @@ HEADERS += \
     Animators/steppedanimator.h \
     differsinterpolate.h \
     skia/skiahelpers.h \
+    skia/pixelbufferpool.h \
     Animators/keyt.h \
     Animators/basedkeyt.h \
     Animators/graphkeyt.h \
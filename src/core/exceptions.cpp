@@ -16,6 +16,7 @@
 
 #include "exceptions.h"
 #include <QMessageBox>
+#include <QGuiApplication>
 
 std::string operator+(const std::string& c, const QString& k) {
     return c + k.toStdString();
@@ -83,6 +84,11 @@ QString gAllTextFromException(const std::exception &e,
 
 void gPrintException(const bool fatal, const QString &allText) {
     const QString txt = fatal ? "Fatal" : "Critical";
+    // no one to dismiss a message box when running headless
+    if(QGuiApplication::platformName() == "offscreen") {
+        qCritical().noquote() << txt + " Error" << allText;
+        return;
+    }
     const auto icon = fatal ? QMessageBox::Critical : QMessageBox::Warning;
     QMessageBox(icon, txt + " Error", allText).exec();
 }
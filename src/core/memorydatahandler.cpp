@@ -25,20 +25,85 @@ MemoryDataHandler::MemoryDataHandler() {
 }
 
 void MemoryDataHandler::addContainer(CacheContainer * const cont) {
-    mContainers << cont;
+    append(cont);
 }
 
 void MemoryDataHandler::removeContainer(CacheContainer * const cont) {
-    mContainers.removeOne(cont);
+    unlink(cont);
 }
 
 void MemoryDataHandler::containerUpdated(CacheContainer * const cont) {
-    removeContainer(cont);
-    addContainer(cont);
+    if(cont == mLast) {
+        // a hit refreshes H even without moving
+        cont->mInflation = mInflation;
+        return;
+    }
+    unlink(cont);
+    append(cont);
 }
 
-CacheContainer *MemoryDataHandler::takeFirst() {
-    const auto cont = mContainers.takeFirst();
-    cont->mHandledByMemoryHandler = false;
-    return cont;
+CacheContainer *MemoryDataHandler::takeNextToFree() {
+    const int nCandidates = 16;
+    // containers that cannot be freed right now are moved to the back,
+    // so a run of them is not walked again on every call
+    const int maxScanned = 8*nCandidates;
+    CacheContainer* best = nullptr;
+    qreal bestValue = 0;
+    auto cont = mFirst;
+    int scanned = 0;
+    for(int i = 0; cont && i < nCandidates && scanned < maxScanned;
+        scanned++) {
+        const auto next = cont->mNextCont;
+        if(!cont->canFreeRAM()) {
+            if(next) {
+                const qreal inflation = cont->mInflation;
+                unlink(cont);
+                append(cont);
+                cont->mInflation = inflation;
+            }
+            cont = next;
+            continue;
+        }
+        i++;
+        // H = L + cost/size, with size in MB
+        const qreal mb = cont->getByteCount()/qreal(1024*1024);
+        qreal value = cont->mInflation;
+        if(mb > 0) {
+            const qreal cost = qMax(qreal(1), cont->cost());
+            value += cost/(mb*cont->evictionWeight());
+        }
+        if(!best || value < bestValue) {
+            best = cont;
+            bestValue = value;
+        }
+        cont = next;
+    }
+    if(!best) return nullptr;
+    mInflation = qMax(mInflation, bestValue);
+    unlink(best);
+    best->mHandledByMemoryHandler = false;
+    return best;
+}
+
+void MemoryDataHandler::append(CacheContainer * const cont) {
+    Q_ASSERT(!cont->mPrevCont && !cont->mNextCont && cont != mFirst);
+    cont->mInflation = mInflation;
+    cont->mPrevCont = mLast;
+    if(mLast) mLast->mNextCont = cont;
+    else mFirst = cont;
+    mLast = cont;
+    mCount++;
+}
+
+void MemoryDataHandler::unlink(CacheContainer * const cont) {
+    const auto prev = cont->mPrevCont;
+    const auto next = cont->mNextCont;
+    if(prev) prev->mNextCont = next;
+    else if(mFirst == cont) mFirst = next;
+    else return;
+    if(next) next->mPrevCont = prev;
+    else mLast = prev;
+    cont->mPrevCont = nullptr;
+    cont->mNextCont = nullptr;
+    mCount--;
 }
@@ -16,12 +16,14 @@
 
 #ifndef MEMORYDATAHANDLER_H
 #define MEMORYDATAHANDLER_H
-#include <QList>
-
 #include "core_global.h"
 
 class CacheContainer;
 
+// Intrusive doubly linked list of the containers that can be freed,
+// ordered from the least to the most recently used.
+// Containers are freed in GreedyDual-Size order, sampled from the
+// least recently used end, so cheap to reproduce bytes go first.
 class CORE_EXPORT MemoryDataHandler {
 public:
     MemoryDataHandler();
@@ -32,10 +34,19 @@ public:
     void removeContainer(CacheContainer * const cont);
     void containerUpdated(CacheContainer * const cont);
 
-    bool isEmpty() const { return mContainers.isEmpty(); }
-    CacheContainer* takeFirst();
+    bool isEmpty() const { return !mFirst; }
+    int count() const { return mCount; }
+    //! @brief Takes the container with the lowest cost per byte
+    //! out of the few least recently used ones.
+    CacheContainer* takeNextToFree();
 private:
-    QList<CacheContainer*> mContainers;
+    void append(CacheContainer * const cont);
+    void unlink(CacheContainer * const cont);
+
+    CacheContainer* mFirst = nullptr;
+    CacheContainer* mLast = nullptr;
+    int mCount = 0;
+    qreal mInflation = 0;
 };
 
 #endif // MEMORYDATAHANDLER_H
@@ -0,0 +1,141 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "pixelbufferpool.h"
+#include "../exceptions.h"
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+    // smaller buffers are cheap for the system allocator
+    const size_t gMinPooledBytes = 64*1024;
+    const qint64 gMaxPooledBytes = 512ll*1024*1024;
+    // four size classes per power of two, at most 25% wasted
+    const int gClassesPerPow = 4;
+    const int gBucketCount = gClassesPerPow*48;
+
+    struct Bucket {
+        std::mutex fMutex;
+        std::vector<void*> fFree;
+    };
+
+    Bucket gBuckets[gBucketCount];
+    std::atomic<qint64> gPooledBytes{0};
+    std::atomic<qint64> gReused{0};
+    std::atomic<qint64> gAllocated{0};
+    std::atomic<qint64> gReusedBytes{0};
+
+    int bucketId(const size_t bytes) {
+        int pow = 0;
+        while((size_t(1) << (pow + 1)) <= bytes) pow++;
+        const size_t base = size_t(1) << pow;
+        const size_t step = base/gClassesPerPow;
+        const size_t cls = (bytes - base + step - 1)/step;
+        return gClassesPerPow*pow + static_cast<int>(cls);
+    }
+
+    size_t bucketCapacity(const int id) {
+        const size_t base = size_t(1) << (id/gClassesPerPow);
+        return base + (id % gClassesPerPow)*(base/gClassesPerPow);
+    }
+
+    void releaseBuffer(void* addr, void* context) {
+        const int id = static_cast<int>(reinterpret_cast<intptr_t>(context));
+        const qint64 capacity = static_cast<qint64>(bucketCapacity(id));
+        if(gPooledBytes.fetch_add(capacity) + capacity > gMaxPooledBytes) {
+            gPooledBytes -= capacity;
+            return std::free(addr);
+        }
+        auto& bucket = gBuckets[id];
+        std::lock_guard<std::mutex> lock(bucket.fMutex);
+        bucket.fFree.push_back(addr);
+    }
+}
+
+void PixelBufferPool::sAllocPixels(SkBitmap& bitmap, const SkImageInfo& info,
+                                   const bool zeroed) {
+    const size_t rowBytes = info.minRowBytes();
+    const size_t bytes = info.computeByteSize(rowBytes);
+    if(SkImageInfo::ByteSizeOverflowed(bytes))
+        RuntimeThrow("Bitmap too large");
+    const int id = bytes < gMinPooledBytes ? -1 : bucketId(bytes);
+    if(id < 0 || id >= gBucketCount) {
+        if(!bitmap.tryAllocPixels(info, rowBytes))
+            RuntimeThrow("Failed to allocate pixels");
+        return;
+    }
+    const size_t capacity = bucketCapacity(id);
+    void* pixels = nullptr;
+    {
+        auto& bucket = gBuckets[id];
+        std::lock_guard<std::mutex> lock(bucket.fMutex);
+        if(!bucket.fFree.empty()) {
+            pixels = bucket.fFree.back();
+            bucket.fFree.pop_back();
+        }
+    }
+    if(pixels) {
+        gPooledBytes -= static_cast<qint64>(capacity);
+        gReused++;
+        gReusedBytes += static_cast<qint64>(bytes);
+        if(zeroed) std::memset(pixels, 0, bytes);
+    } else {
+        pixels = zeroed ? std::calloc(1, capacity) : std::malloc(capacity);
+        if(!pixels) RuntimeThrow("Failed to allocate pixels");
+        gAllocated++;
+    }
+    // on failure the buffer goes back to the pool through releaseBuffer
+    const auto context = reinterpret_cast<void*>(static_cast<intptr_t>(id));
+    if(!bitmap.installPixels(info, pixels, rowBytes, &releaseBuffer, context))
+        RuntimeThrow("Failed to install pixels");
+}
+
+size_t PixelBufferPool::sCapacity(const size_t bytes) {
+    if(bytes < gMinPooledBytes) return bytes;
+    const int id = bucketId(bytes);
+    if(id >= gBucketCount) return bytes;
+    return bucketCapacity(id);
+}
+
+qint64 PixelBufferPool::sTrim(const qint64 bytes) {
+    qint64 freed = 0;
+    for(int id = gBucketCount - 1; id >= 0 && freed < bytes; id--) {
+        auto& bucket = gBuckets[id];
+        const qint64 capacity = static_cast<qint64>(bucketCapacity(id));
+        std::lock_guard<std::mutex> lock(bucket.fMutex);
+        while(!bucket.fFree.empty() && freed < bytes) {
+            std::free(bucket.fFree.back());
+            bucket.fFree.pop_back();
+            gPooledBytes -= capacity;
+            freed += capacity;
+        }
+    }
+    return freed;
+}
+
+qint64 PixelBufferPool::sClear() {
+    return sTrim(std::numeric_limits<qint64>::max());
+}
+
+PixelBufferPool::Stats PixelBufferPool::sStats() {
+    return {gReused, gAllocated, gReusedBytes, gPooledBytes};
+}
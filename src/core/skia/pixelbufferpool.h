@@ -0,0 +1,51 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef PIXELBUFFERPOOL_H
+#define PIXELBUFFERPOOL_H
+
+#include "skiaincludes.h"
+#include "../core_global.h"
+
+//! @brief Recycles large pixel buffers of render data and raster effects,
+//! released buffers are kept in size buckets instead of freed.
+class CORE_EXPORT PixelBufferPool {
+public:
+    struct Stats {
+        qint64 fReused; // allocations served from the pool
+        qint64 fAllocated; // allocations that reached the system allocator
+        qint64 fReusedBytes;
+        qint64 fPooledBytes; // currently held by the pool
+    };
+
+    //! @brief Allocates the bitmap pixels, small bitmaps bypass the pool.
+    //! Recycled buffers hold old pixels, pass zeroed false
+    //! only if the caller writes every pixel.
+    static void sAllocPixels(SkBitmap& bitmap, const SkImageInfo& info,
+                             const bool zeroed = true);
+    //! @brief Bytes held by a buffer allocated for the given size,
+    //! pooled buffers are rounded up to their size class.
+    static size_t sCapacity(const size_t bytes);
+
+    //! @brief Frees pooled buffers, returns the number of bytes freed.
+    static qint64 sTrim(const qint64 bytes);
+    static qint64 sClear();
+
+    static Stats sStats();
+};
+
+#endif // PIXELBUFFERPOOL_H
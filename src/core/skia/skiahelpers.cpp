@@ -16,18 +16,22 @@
 
 #include "skiahelpers.h"
 #include "exceptions.h"
+#include "pixelbufferpool.h"
 
 sk_sp<SkImage> SkiaHelpers::makeCopy(const sk_sp<SkImage>& img) {
     if(!img) return nullptr;
     SkPixmap pix;
     if(!img->peekPixels(&pix)) return img->makeRasterImage();
-    return SkImage::MakeRasterCopy(pix);
+    SkBitmap btmp;
+    PixelBufferPool::sAllocPixels(btmp, pix.info(), false);
+    btmp.writePixels(pix);
+    return transferDataToSkImage(btmp);
 }
 
 SkBitmap SkiaHelpers::makeCopy(const SkBitmap& btmp) {
     if(btmp.isNull()) return SkBitmap();
     SkBitmap result;
-    result.allocPixels(btmp.info());
+    PixelBufferPool::sAllocPixels(result, btmp.info(), false);
     result.writePixels(btmp.pixmap());
     return result;
 }
@@ -70,9 +74,12 @@ sk_sp<SkImage> SkiaHelpers::transferDataToSkImage(SkBitmap &bitmap) {
 
 void SkiaHelpers::writeImg(const sk_sp<SkImage> &img,
                            eWriteStream& dst) {
+    // the raster copy has to outlive the pixmap
+    sk_sp<SkImage> rasterImg = img;
     SkPixmap pix;
-    if(!img->peekPixels(&pix)) {
-        if(!img->makeRasterImage()->peekPixels(&pix)) {
+    if(!rasterImg->peekPixels(&pix)) {
+        rasterImg = img->makeRasterImage();
+        if(!rasterImg || !rasterImg->peekPixels(&pix)) {
             RuntimeThrow("Could not peek image pixels");
         }
     }
@@ -84,6 +91,81 @@ sk_sp<SkImage> SkiaHelpers::readImg(eReadStream &src) {
     return SkiaHelpers::transferDataToSkImage(btmp);
 }
 
+void SkiaHelpers::writeImgCompressed(const sk_sp<SkImage> &img,
+                                     eWriteStream& dst) {
+    // the raster copy has to outlive the pixmap
+    sk_sp<SkImage> rasterImg = img;
+    SkPixmap pix;
+    if(!rasterImg->peekPixels(&pix)) {
+        rasterImg = img->makeRasterImage();
+        if(!rasterImg || !rasterImg->peekPixels(&pix)) {
+            RuntimeThrow("Could not peek image pixels");
+        }
+    }
+    const int width = pix.width();
+    const int height = pix.height();
+    const int tileSize = 128;
+    dst << width;
+    dst << height;
+    dst << tileSize;
+    QByteArray tile;
+    for(int ty = 0; ty < height; ty += tileSize) {
+        const int th = qMin(tileSize, height - ty);
+        for(int tx = 0; tx < width; tx += tileSize) {
+            const int tw = qMin(tileSize, width - tx);
+            const int rowBytes = tw*4;
+            tile.resize(rowBytes*th);
+            bool transparent = true;
+            for(int y = 0; y < th; y++) {
+                const auto row = static_cast<const uint32_t*>(
+                            pix.addr(tx, ty + y));
+                memcpy(tile.data() + y*rowBytes, row,
+                       static_cast<size_t>(rowBytes));
+                for(int x = 0; transparent && x < tw; x++) {
+                    if(row[x]) transparent = false;
+                }
+            }
+            if(transparent) dst << QByteArray();
+            else dst << qCompress(tile, 1);
+        }
+    }
+}
+
+sk_sp<SkImage> SkiaHelpers::readImgCompressed(eReadStream &src) {
+    int width, height, tileSize;
+    src >> width;
+    src >> height;
+    src >> tileSize;
+    if(tileSize <= 0) RuntimeThrow("Invalid tile size");
+    SkBitmap btmp;
+    const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
+    // every tile is either copied or cleared
+    PixelBufferPool::sAllocPixels(btmp, info, false);
+    QByteArray compressed;
+    for(int ty = 0; ty < height; ty += tileSize) {
+        const int th = qMin(tileSize, height - ty);
+        for(int tx = 0; tx < width; tx += tileSize) {
+            const int tw = qMin(tileSize, width - tx);
+            const int rowBytes = tw*4;
+            src >> compressed;
+            if(compressed.isEmpty()) {
+                for(int y = 0; y < th; y++) {
+                    memset(btmp.getAddr(tx, ty + y), 0,
+                           static_cast<size_t>(rowBytes));
+                }
+                continue;
+            }
+            const auto tile = qUncompress(compressed);
+            if(tile.size() != rowBytes*th) RuntimeThrow("Corrupted image tile");
+            for(int y = 0; y < th; y++) {
+                memcpy(btmp.getAddr(tx, ty + y), tile.data() + y*rowBytes,
+                       static_cast<size_t>(rowBytes));
+            }
+        }
+    }
+    return SkiaHelpers::transferDataToSkImage(btmp);
+}
+
 void SkiaHelpers::writePixmap(const SkPixmap &pix,
                               eWriteStream& dst) {
     const int width = pix.width();
@@ -101,7 +183,7 @@ SkBitmap SkiaHelpers::readBitmap(eReadStream &src) {
     src >> height;
     SkBitmap btmp;
     const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
-    btmp.allocPixels(info);
+    PixelBufferPool::sAllocPixels(btmp, info);
     const qint64 readBytes = width*height*4*
             static_cast<qint64>(sizeof(uchar));
     src.read(btmp.getPixels(), readBytes);
@@ -45,6 +45,13 @@ namespace SkiaHelpers {
     CORE_EXPORT
     sk_sp<SkImage> readImg(eReadStream& src);
 
+    //! @brief Writes the image as zlib compressed tiles,
+    //! fully transparent tiles are skipped.
+    CORE_EXPORT
+    void writeImgCompressed(const sk_sp<SkImage>& img, eWriteStream &dst);
+    CORE_EXPORT
+    sk_sp<SkImage> readImgCompressed(eReadStream& src);
+
     CORE_EXPORT
     SkBitmap readBitmap(eReadStream &src);
     CORE_EXPORT
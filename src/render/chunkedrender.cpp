@@ -0,0 +1,138 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "chunkedrender.h"
+
+#include <iostream>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QThread>
+#include <QDir>
+#include "Private/esettings.h"
+#include "exceptions.h"
+
+ChunkedRender::ChunkedRender(const QStringList& baseArgs,
+                             const QString& output,
+                             const FrameRange& range,
+                             const AVRational& frameDuration,
+                             const int nChunks, const int nJobs,
+                             QObject* const parent) :
+    QObject(parent), mBaseArgs(baseArgs), mOutput(output),
+    mRange(range), mFrameDuration(frameDuration),
+    mJobs(qMax(1, nJobs)) {
+    const QFileInfo outInfo(output);
+    const QString base = outInfo.dir().filePath(outInfo.completeBaseName());
+    const QString suffix = outInfo.suffix();
+    const int nFrames = range.span();
+    const int chunks = qBound(1, nChunks, nFrames);
+    int first = range.fMin;
+    for(int i = 0; i < chunks; i++) {
+        const int last = range.fMin + (i + 1)*nFrames/chunks - 1;
+        RenderChunk chunk;
+        chunk.fRange = {first, last};
+        const QString name = base + QString(".chunk%1-%2").arg(first).arg(last);
+        chunk.fPath = name + "." + suffix;
+        chunk.fPartPath = name + ".part." + suffix;
+        mChunks << chunk;
+        first = last + 1;
+    }
+}
+
+void ChunkedRender::start() {
+    while(mRunning < mJobs && mNextChunk < mChunks.count()) {
+        startNextChunk();
+    }
+    if(mRunning == 0) merge();
+}
+
+void ChunkedRender::startNextChunk() {
+    auto& chunk = mChunks[mNextChunk++];
+    const auto& range = chunk.fRange;
+    if(QFileInfo(chunk.fPath).isFile()) {
+        std::cout << "Chunk " << range.fMin << "-" << range.fMax <<
+                     " already rendered" << std::endl;
+        return;
+    }
+    QFile(chunk.fPartPath).remove();
+
+    const int threads = qMax(1, eSettings::sCpuThreadsCapped()/mJobs);
+    const int memoryMB = qMax(1, eSettings::sRamMBCap().fValue/mJobs);
+    QStringList args = mBaseArgs;
+    args << "--frames" << QString("%1-%2").arg(range.fMin).arg(range.fMax);
+    args << "--output" << chunk.fPartPath;
+    args << "--threads" << QString::number(threads);
+    args << "--memory" << QString::number(memoryMB);
+
+    const auto process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::ForwardedChannels);
+    connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished),
+            this, [this, &chunk, process]() {
+        chunkFinished(chunk, process);
+    });
+    // finished is never emitted for a process that did not start
+    connect(process, &QProcess::errorOccurred,
+            this, [this, &chunk, process](const QProcess::ProcessError error) {
+        if(error != QProcess::FailedToStart) return;
+        std::cerr << process->errorString().toStdString() << std::endl;
+        chunkFinished(chunk, process);
+    });
+    std::cout << "Starting chunk " << range.fMin << "-" << range.fMax <<
+                 std::endl;
+    mRunning++;
+    chunk.fTimer.start();
+    process->start(QCoreApplication::applicationFilePath(), args);
+}
+
+void ChunkedRender::chunkFinished(RenderChunk& chunk, QProcess* const process) {
+    mRunning--;
+    const auto& range = chunk.fRange;
+    const bool success = process->error() != QProcess::FailedToStart &&
+                         process->exitStatus() == QProcess::NormalExit &&
+                         process->exitCode() == 0 &&
+                         QFile::rename(chunk.fPartPath, chunk.fPath);
+    process->deleteLater();
+    if(success) {
+        std::cout << "Chunk " << range.fMin << "-" << range.fMax <<
+                     " rendered in " << chunk.fTimer.elapsed() << " ms" <<
+                     std::endl;
+    } else {
+        std::cerr << "Chunk " << range.fMin << "-" << range.fMax <<
+                     " failed" << std::endl;
+        mFailed = true;
+    }
+    if(!mFailed) start();
+    else if(mRunning == 0) emit finished(false);
+}
+
+void ChunkedRender::merge() {
+    QList<OutputSegment> segments;
+    for(const auto& chunk : mChunks) {
+        segments << OutputSegment{chunk.fPath, chunk.fRange.fMin - mRange.fMin};
+    }
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        SegmentMerger::sMerge(segments, mFrameDuration, mOutput);
+    } catch(const std::exception& e) {
+        std::cerr << gAllTextFromException(e).toStdString() << std::endl;
+        emit finished(false);
+        return;
+    }
+    std::cout << "Merged " << segments.count() << " segments in " <<
+                 timer.elapsed() << " ms" << std::endl;
+    for(const auto& segment : segments) QFile(segment.fPath).remove();
+    emit finished(true);
+}
@@ -0,0 +1,67 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CHUNKEDRENDER_H
+#define CHUNKEDRENDER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QElapsedTimer>
+#include "framerange.h"
+#include "segmentmerger.h"
+
+struct RenderChunk {
+    FrameRange fRange;
+    QString fPath;
+    QString fPartPath;
+    QElapsedTimer fTimer;
+};
+
+// Splits a frame range into chunks rendered by separate enve-render
+// processes, then stream-copies the segments into the final output.
+// Finished segments are kept until the merge succeeds,
+// so an interrupted render resumes from the missing chunks.
+class ChunkedRender : public QObject {
+    Q_OBJECT
+public:
+    ChunkedRender(const QStringList& baseArgs,
+                  const QString& output,
+                  const FrameRange& range,
+                  const AVRational& frameDuration,
+                  const int nChunks, const int nJobs,
+                  QObject* const parent = nullptr);
+
+    void start();
+signals:
+    void finished(const bool success);
+private:
+    void startNextChunk();
+    void chunkFinished(RenderChunk& chunk, QProcess* const process);
+    void merge();
+
+    const QStringList mBaseArgs;
+    const QString mOutput;
+    const FrameRange mRange;
+    const AVRational mFrameDuration;
+    const int mJobs;
+
+    QList<RenderChunk> mChunks;
+    int mNextChunk = 0;
+    int mRunning = 0;
+    bool mFailed = false;
+};
+
+#endif // CHUNKEDRENDER_H
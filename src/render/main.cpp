@@ -0,0 +1,493 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QSurfaceFormat>
+#include <QFileInfo>
+#include <QTimer>
+#include "hardwareinfo.h"
+#include "Private/esettings.h"
+#include "Private/document.h"
+#include "efiltersettings.h"
+#include "effectsloader.h"
+#include "memoryhandler.h"
+#include "renderhandler.h"
+#include "videoencoder.h"
+#include "canvas.h"
+#include "ReadWrite/filefooter.h"
+#include "ReadWrite/evformat.h"
+#include "XML/xevimporter.h"
+#include "chunkedrender.h"
+
+using RenderInstances = QList<stdsptr<RenderInstanceSettings>>;
+
+void setDefaultFormat() {
+    QSurfaceFormat format;
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    format.setSamples(0);
+    QSurfaceFormat::setDefaultFormat(format);
+}
+
+void loadEVFile(const QString &path, Document& document,
+                RenderInstances& instances) {
+    QFile file(path);
+    if(!file.exists()) RuntimeThrow("File does not exist " + path);
+    if(!file.open(QIODevice::ReadOnly))
+        RuntimeThrow("Could not open file " + path);
+    try {
+        const int evVersion = FileFooter::sReadEvFileVersion(&file);
+        if(evVersion <= 0) RuntimeThrow("Incompatible or incomplete data");
+        eReadStream readStream(evVersion, &file);
+        readStream.setPath(path);
+
+        const qint64 savedPos = file.pos();
+        const qint64 pos = file.size() - FileFooter::sSize(evVersion) -
+                qint64(sizeof(int));
+        file.seek(pos);
+        readStream.readFutureTable();
+        file.seek(savedPos);
+        readStream.readCheckpoint("File beginning pos mismatch");
+        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
+            int nScenes; readStream >> nScenes;
+            for(int i = 0; i < nScenes; i++) {
+                const auto scene = document.createNewScene();
+                if(evVersion >= EvFormat::readSceneSettingsBeforeContent) {
+                    scene->readSettings(readStream);
+                }
+            }
+            // there is no layout without the main window
+            if(evVersion >= EvFormat::framedLayout) {
+                readStream.skipFrame("Error skipping Layout");
+                readStream.readCheckpoint("Error skipping Layout");
+            } else {
+                readStream.skipToCheckpoint("Error skipping Layout");
+            }
+        }
+        document.readScenes(readStream);
+        readStream.readCheckpoint("Error reading Document");
+        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
+            int nInstances; readStream >> nInstances;
+            for(int i = 0; i < nInstances; i++) {
+                const auto instance =
+                        std::make_shared<RenderInstanceSettings>(nullptr);
+                instance->read(readStream);
+                bool checked; readStream >> checked;
+                if(checked) instances << instance;
+            }
+            readStream.readCheckpoint("Error reading Render Queue");
+        }
+    } catch(...) {
+        file.close();
+        RuntimeThrow("Error while reading from file " + path);
+    }
+    file.close();
+}
+
+void loadXevFile(const QString &path, Document& document) {
+    try {
+        ZipFileLoader fileLoader;
+        fileLoader.setZipPath(path);
+
+        QList<Canvas*> scenes;
+        document.readDocumentXEV(fileLoader, scenes);
+
+        XevReadBoxesHandler boxReadHandler;
+        const RuntimeIdToWriteId objListIdConv;
+        document.readScenesXEV(boxReadHandler, fileLoader,
+                               scenes, objListIdConv);
+    } catch(...) {
+        RuntimeThrow("Error while reading from file " + path);
+    }
+}
+
+Canvas* findScene(const Document& document, const QString& name) {
+    for(const auto& scene : document.fScenes) {
+        if(scene->prp_getName() == name) return scene.get();
+    }
+    RuntimeThrow("No scene named '" + name + "'");
+}
+
+FrameRange parseFrameRange(const QString& str) {
+    const auto minMax = str.split('-');
+    bool minOk = false;
+    bool maxOk = false;
+    const int min = minMax.first().toInt(&minOk);
+    const int max = minMax.last().toInt(&maxOk);
+    if(minMax.count() > 2 || !minOk || !maxOk || max < min)
+        RuntimeThrow("Invalid frame range '" + str + "'");
+    return {min, max};
+}
+
+stdsptr<RenderInstanceSettings> setupInstance(
+        const QCommandLineParser& parser,
+        const Document& document,
+        const RenderInstances& queued) {
+    Canvas* scene = nullptr;
+    if(parser.isSet("scene")) scene = findScene(document, parser.value("scene"));
+
+    stdsptr<RenderInstanceSettings> instance;
+    for(const auto& queuedInstance : queued) {
+        const auto target = queuedInstance->getTargetCanvas();
+        if(!target || (scene && target != scene)) continue;
+        instance = queuedInstance;
+        break;
+    }
+    if(!instance) {
+        if(!scene && document.fScenes.isEmpty())
+            RuntimeThrow("No scenes to render");
+        if(!scene) scene = document.fScenes.first().get();
+        instance = std::make_shared<RenderInstanceSettings>(scene);
+    }
+
+    auto renderSettings = instance->getRenderSettings();
+    if(parser.isSet("frames")) {
+        const auto range = parseFrameRange(parser.value("frames"));
+        renderSettings.fMinFrame = range.fMin;
+        renderSettings.fMaxFrame = range.fMax;
+    }
+    if(parser.isSet("resolution")) {
+        bool ok = false;
+        const qreal percent = parser.value("resolution").toDouble(&ok);
+        if(!ok || percent <= 0) RuntimeThrow("Invalid resolution");
+        renderSettings.fResolution = percent/100;
+        renderSettings.fVideoWidth = qRound(renderSettings.fBaseWidth*
+                                            renderSettings.fResolution);
+        renderSettings.fVideoHeight = qRound(renderSettings.fBaseHeight*
+                                             renderSettings.fResolution);
+    }
+    if(parser.isSet("fps")) {
+        bool ok = false;
+        const qreal fps = parser.value("fps").toDouble(&ok);
+        if(!ok || fps <= 0) RuntimeThrow("Invalid fps");
+        renderSettings.fFps = fps;
+    }
+    instance->setRenderSettings(renderSettings);
+
+    if(parser.isSet("profile")) {
+        const QString nameOrPath = parser.value("profile");
+        auto profile = OutputSettingsProfile::sGetByName(nameOrPath);
+        if(!profile && QFileInfo(nameOrPath).isFile()) {
+            const auto loaded = enve::make_shared<OutputSettingsProfile>();
+            loaded->load(nameOrPath);
+            OutputSettingsProfile::sOutputProfiles << loaded;
+            profile = loaded.get();
+        }
+        if(!profile) RuntimeThrow("No output profile '" + nameOrPath + "'");
+        instance->setOutputSettingsProfile(profile);
+    }
+    if(parser.isSet("output")) {
+        instance->setOutputDestination(parser.value("output"));
+    }
+    const QString dst = instance->getOutputDestination();
+    if(dst.isEmpty()) RuntimeThrow("No output destination");
+
+    auto outputSettings = instance->getOutputRenderSettings();
+    if(parser.isSet("format")) {
+        const auto name = parser.value("format").toUtf8();
+        outputSettings.fOutputFormat = av_guess_format(name.data(),
+                                                       nullptr, nullptr);
+        if(!outputSettings.fOutputFormat)
+            RuntimeThrow("Unrecognized format '" +
+                         parser.value("format") + "'");
+    } else if(!outputSettings.fOutputFormat) {
+        outputSettings.fOutputFormat = av_guess_format(
+                    nullptr, dst.toUtf8().data(), nullptr);
+    }
+    if(parser.isSet("video-codec")) {
+        const auto name = parser.value("video-codec").toUtf8();
+        outputSettings.fVideoCodec = avcodec_find_encoder_by_name(name.data());
+        if(!outputSettings.fVideoCodec)
+            RuntimeThrow("Unrecognized video codec '" +
+                         parser.value("video-codec") + "'");
+        outputSettings.fVideoEnabled = true;
+        outputSettings.fVideoPixelFormat = AV_PIX_FMT_NONE;
+    } else if(!outputSettings.fVideoCodec && outputSettings.fOutputFormat) {
+        const auto codecId = outputSettings.fOutputFormat->video_codec;
+        outputSettings.fVideoCodec = avcodec_find_encoder(codecId);
+        outputSettings.fVideoEnabled = outputSettings.fVideoCodec;
+    }
+    if(parser.isSet("pixel-format")) {
+        const auto name = parser.value("pixel-format").toUtf8();
+        outputSettings.fVideoPixelFormat = av_get_pix_fmt(name.data());
+        if(outputSettings.fVideoPixelFormat == AV_PIX_FMT_NONE)
+            RuntimeThrow("Unrecognized pixel format '" +
+                         parser.value("pixel-format") + "'");
+    } else if(outputSettings.fVideoPixelFormat == AV_PIX_FMT_NONE &&
+              outputSettings.fVideoCodec &&
+              outputSettings.fVideoCodec->pix_fmts) {
+        outputSettings.fVideoPixelFormat = outputSettings.fVideoCodec->pix_fmts[0];
+    }
+    if(parser.isSet("video-bitrate")) {
+        outputSettings.fVideoBitrate = parser.value("video-bitrate").toInt();
+    }
+    if(parser.isSet("video-threads")) {
+        outputSettings.fVideoThreads = parser.value("video-threads").toInt();
+    }
+    if(parser.isSet("no-audio")) outputSettings.fAudioEnabled = false;
+    instance->setOutputRenderSettings(outputSettings);
+
+    return instance;
+}
+
+void printRenderInfo(const RenderInstanceSettings& instance) {
+    const auto& renderSettings = instance.getRenderSettings();
+    const auto& outputSettings = instance.getOutputRenderSettings();
+    std::cout << "Render:" << std::endl;
+    std::cout << "          Scene: " << instance.getTargetCanvas()->
+                 prp_getName().toStdString() << std::endl;
+    std::cout << "         Frames: " << renderSettings.fMinFrame << " - " <<
+                 renderSettings.fMaxFrame << std::endl;
+    std::cout << "     Resolution: " << renderSettings.fVideoWidth << "x" <<
+                 renderSettings.fVideoHeight << std::endl;
+    std::cout << "            FPS: " << renderSettings.fFps << std::endl;
+    std::cout << "         Output: " <<
+                 instance.getOutputDestination().toStdString() << std::endl;
+    if(outputSettings.fVideoCodec && outputSettings.fVideoEnabled) {
+        std::cout << "    Video codec: " <<
+                     outputSettings.fVideoCodec->name << std::endl;
+    }
+    if(outputSettings.fAudioCodec && outputSettings.fAudioEnabled) {
+        std::cout << "    Audio codec: " <<
+                     outputSettings.fAudioCodec->name << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    // render without a display unless told otherwise
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    QApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
+    setDefaultFormat();
+    QApplication app(argc, argv);
+    QApplication::setApplicationName("enve-render");
+    setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render an enve scene without the GUI.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "Input .ev or .xev file.");
+    parser.addOptions({
+        {{"s", "scene"}, "Name of the scene to render.", "name"},
+        {{"f", "frames"}, "Frame range to render.", "first-last"},
+        {{"r", "resolution"}, "Resolution in percent.", "percent"},
+        {"fps", "Output frame rate.", "fps"},
+        {{"o", "output"}, "Output file.", "file"},
+        {{"p", "profile"}, "Output profile name or .eProf file.", "profile"},
+        {"format", "Output container format.", "name"},
+        {"video-codec", "Video encoder.", "name"},
+        {"pixel-format", "Video pixel format.", "name"},
+        {"video-bitrate", "Video bitrate in bits per second.", "bitrate"},
+        {"video-threads", "Video encoder threads, 0 for automatic.", "count"},
+        {"no-audio", "Do not render audio."},
+        {"threads", "Number of CPU threads to use.", "count"},
+        {"memory", "Memory cap in MB.", "MB"},
+        {"chunks", "Split the frame range into chunks "
+                   "rendered in separate processes.", "count"},
+        {"jobs", "Number of chunks rendered at the same time.", "count"}
+    });
+    parser.process(app);
+    const auto positional = parser.positionalArguments();
+    if(positional.count() != 1) parser.showHelp(1);
+    const QString path = positional.first();
+
+    try {
+        HardwareInfo::sUpdateInfo();
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+    }
+
+    eSettings settings(HardwareInfo::sCpuThreads(),
+                       HardwareInfo::sRamKB(),
+                       HardwareInfo::sGpuVendor());
+    try {
+        settings.loadFromFile();
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+    }
+    if(parser.isSet("threads"))
+        settings.fCpuThreadsCap = parser.value("threads").toInt();
+    if(parser.isSet("memory"))
+        settings.fRamMBCap = intMB(parser.value("memory").toInt());
+
+    eFilterSettings filterSettings;
+
+    MemoryHandler memoryHandler;
+    TaskScheduler taskScheduler;
+    QObject::connect(&memoryHandler, &MemoryHandler::enteredCriticalState,
+                     &taskScheduler, &TaskScheduler::enterCriticalMemoryState);
+    QObject::connect(&memoryHandler, &MemoryHandler::finishedCriticalState,
+                     &taskScheduler, &TaskScheduler::finishCriticalMemoryState);
+
+    Document document(taskScheduler);
+    Actions actions(document);
+
+    EffectsLoader effectsLoader;
+    bool gpu = true;
+    try {
+        effectsLoader.initializeGpu();
+        taskScheduler.initializeGpu();
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+        gpu = false;
+    }
+    if(!gpu) {
+        std::cerr << "No usable GPU, rendering on the CPU only. " <<
+                     "Shader effects will not be rendered." << std::endl;
+        settings.fAccPreference = AccPreference::cpuStrongPreference;
+        settings.fPathGpuAcc = false;
+    }
+    effectsLoader.iniCustomPathEffects();
+    effectsLoader.iniCustomRasterEffects();
+    if(gpu) {
+        try {
+            effectsLoader.iniShaderEffects();
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+        }
+    }
+    effectsLoader.iniCustomBoxes();
+
+    eSoundSettings soundSettings;
+    AudioHandler audioHandler;
+
+    const auto videoEncoder = enve::make_shared<VideoEncoder>();
+    RenderHandler renderHandler(document, audioHandler,
+                                *videoEncoder, memoryHandler);
+
+    OutputSettingsProfile::sLoadProfiles();
+
+    RenderInstances queued;
+    stdsptr<RenderInstanceSettings> instance;
+    try {
+        const QString suffix = QFileInfo(path).suffix();
+        if(suffix == "ev") {
+            loadEVFile(path, document, queued);
+        } else if(suffix == "xev") {
+            loadXevFile(path, document);
+        } else RuntimeThrow("Unrecognized file extension " + suffix);
+        document.setPath(path);
+        instance = setupInstance(parser, document, queued);
+    } catch(const std::exception& e) {
+        std::cerr << gAllTextFromException(e).toStdString() << std::endl;
+        return 1;
+    }
+
+    const auto scene = instance->getTargetCanvas();
+    printRenderInfo(*instance);
+
+    const auto& renderSettings = instance->getRenderSettings();
+    int nChunks = parser.value("chunks").toInt();
+    const bool imageSequence =
+            instance->getOutputRenderSettings().isImageSequence();
+    if(nChunks > 1 && imageSequence) {
+        std::cout << "Image sequence frames are already written in parallel, "
+                     "ignoring --chunks." << std::endl;
+        nChunks = 1;
+    }
+    if(nChunks > 1) {
+        QStringList baseArgs{path, "--scene", scene->prp_getName()};
+        const QStringList passOn{"resolution", "fps", "profile", "format",
+                                 "video-codec", "pixel-format",
+                                 "video-bitrate", "video-threads"};
+        for(const auto& option : passOn) {
+            if(!parser.isSet(option)) continue;
+            baseArgs << "--" + option << parser.value(option);
+        }
+        if(parser.isSet("no-audio")) baseArgs << "--no-audio";
+        const int nJobs = parser.isSet("jobs") ?
+                    parser.value("jobs").toInt() : nChunks;
+        const FrameRange range{renderSettings.fMinFrame,
+                               renderSettings.fMaxFrame};
+        const auto frameDuration = av_d2q(1/renderSettings.fFps, 100000);
+        ChunkedRender chunkedRender(baseArgs, instance->getOutputDestination(),
+                                    range, frameDuration, nChunks, nJobs);
+        QObject::connect(&chunkedRender, &ChunkedRender::finished,
+                         [&app](const bool success) {
+            app.exit(success ? 0 : 1);
+        });
+        QTimer::singleShot(0, &chunkedRender, &ChunkedRender::start);
+        return app.exec();
+    }
+
+    document.addVisibleScene(scene);
+    const int minFrame = renderSettings.fMinFrame;
+    const int maxFrame = renderSettings.fMaxFrame;
+    QElapsedTimer totalTimer;
+    QElapsedTimer frameTimer;
+    int lastFrame = minFrame - 1;
+    QObject::connect(instance.get(), &RenderInstanceSettings::renderFrameChanged,
+                     [&](const int frame) {
+        const int nFrames = frame - lastFrame;
+        if(nFrames <= 0) return;
+        const qreal frameMs = frameTimer.restart()/qreal(nFrames);
+        lastFrame = frame;
+        std::cout << "Frame " << frame << " (" << frame - minFrame + 1 <<
+                     "/" << maxFrame - minFrame + 1 << ") " <<
+                     QString::number(frameMs, 'f', 1).toStdString() <<
+                     " ms/frame" << std::endl;
+    });
+    QObject::connect(instance.get(), &RenderInstanceSettings::stateChanged,
+                     [&](const RenderState state) {
+        if(state == RenderState::finished) {
+            const qreal totalSec = totalTimer.elapsed()/1000.;
+            const int nFrames = maxFrame - minFrame + 1;
+            std::cout << "Rendered " << nFrames << " frames in " <<
+                         QString::number(totalSec, 'f', 2).toStdString() <<
+                         " s (" << QString::number(nFrames/totalSec, 'f', 2).
+                         toStdString() << " fps)" << std::endl;
+            const qreal encodeSec = videoEncoder->encodeTimeUs()/1000000.;
+            const int nEncoded = videoEncoder->encodedFrames();
+            if(nEncoded > 0 && encodeSec > 0) {
+                std::cout << "Encoded " << nEncoded << " frames in " <<
+                             QString::number(encodeSec, 'f', 2).toStdString() <<
+                             " s (" << QString::number(nEncoded/encodeSec, 'f', 2).
+                             toStdString() << " fps)" << std::endl;
+                const qreal convertMs = videoEncoder->convertTimeUs()/1000.;
+                std::cout << "Color conversion " <<
+                             QString::number(convertMs/nEncoded, 'f', 2).
+                             toStdString() << " ms/frame" << std::endl;
+            }
+            app.exit(0);
+        } else if(state == RenderState::error) {
+            std::cerr << "Render failed: " <<
+                         instance->getRenderError().toStdString() << std::endl;
+            app.exit(1);
+        } else if(state == RenderState::none) {
+            std::cerr << "Render interrupted" << std::endl;
+            app.exit(1);
+        }
+    });
+
+    totalTimer.start();
+    frameTimer.start();
+    renderHandler.renderFromSettings(instance.get());
+    if(instance->getCurrentState() == RenderState::error) return 1;
+
+    try {
+        return app.exec();
+    } catch(const std::exception& e) {
+        gPrintExceptionFatal(e);
+        return 1;
+    }
+}
@@ -0,0 +1,78 @@
+# enve - 2D animations software
+# Copyright (C) 2016-2020 Maurycy Liebner
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Headless command-line renderer, shares the output pipeline with the app
+
+QT += multimedia core gui svg opengl qml xml widgets
+LIBS += -lavutil -lavformat -lavcodec -lswscale -lswresample
+CONFIG += c++14 console
+CONFIG -= app_bundle
+DEFINES += QT_NO_FOREACH
+
+# Include third-party dependencies from core
+include(../core/core.pri)
+
+ENVE_CORE_FOLDER = ../core
+ENVE_APP_FOLDER = ../app
+
+INCLUDEPATH += $$ENVE_CORE_FOLDER $$ENVE_APP_FOLDER
+DEPENDPATH += $$ENVE_CORE_FOLDER $$ENVE_APP_FOLDER
+LIBS += -L$$OUT_PWD/../core -lenvecore
+
+win32 { # Windows
+    CONFIG -= debug_and_release
+} unix {
+    GPERFTOOLS_FOLDER = $$THIRD_PARTY_FOLDER/gperftools
+    INCLUDEPATH += $$GPERFTOOLS_FOLDER/include
+    LIBS += -L$$GPERFTOOLS_FOLDER/.libs -ltcmalloc
+}
+
+TARGET = enve-render
+TEMPLATE = app
+
+SOURCES += main.cpp \
+    chunkedrender.cpp \
+    segmentmerger.cpp \
+    $$ENVE_APP_FOLDER/GUI/ColorWidgets/colorwidgetshaders.cpp \
+    $$ENVE_APP_FOLDER/GUI/audiohandler.cpp \
+    $$ENVE_APP_FOLDER/effectsloader.cpp \
+    $$ENVE_APP_FOLDER/hardwareinfo.cpp \
+    $$ENVE_APP_FOLDER/memorychecker.cpp \
+    $$ENVE_APP_FOLDER/memoryhandler.cpp \
+    $$ENVE_APP_FOLDER/outputsettings.cpp \
+    $$ENVE_APP_FOLDER/renderhandler.cpp \
+    $$ENVE_APP_FOLDER/renderinstancesettings.cpp \
+    $$ENVE_APP_FOLDER/rendersettings.cpp \
+    $$ENVE_APP_FOLDER/videoencoder.cpp \
+    $$ENVE_APP_FOLDER/imagesequencewriter.cpp
+
+HEADERS += \
+    chunkedrender.h \
+    segmentmerger.h \
+    $$ENVE_APP_FOLDER/GUI/ColorWidgets/colorwidgetshaders.h \
+    $$ENVE_APP_FOLDER/GUI/audiohandler.h \
+    $$ENVE_APP_FOLDER/effectsloader.h \
+    $$ENVE_APP_FOLDER/hardwareinfo.h \
+    $$ENVE_APP_FOLDER/memorychecker.h \
+    $$ENVE_APP_FOLDER/memoryhandler.h \
+    $$ENVE_APP_FOLDER/outputsettings.h \
+    $$ENVE_APP_FOLDER/renderhandler.h \
+    $$ENVE_APP_FOLDER/renderinstancesettings.h \
+    $$ENVE_APP_FOLDER/rendersettings.h \
+    $$ENVE_APP_FOLDER/videoencoder.h \
+    $$ENVE_APP_FOLDER/imagesequencewriter.h
+
+RESOURCES += $$ENVE_APP_FOLDER/resources.qrc
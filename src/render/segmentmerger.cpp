@@ -0,0 +1,161 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "segmentmerger.h"
+
+#include <QVector>
+#include "exceptions.h"
+
+static QString avErrorString(const int errId) {
+    char errMsg[AV_ERROR_MAX_STRING_SIZE];
+    av_make_error_string(errMsg, AV_ERROR_MAX_STRING_SIZE, errId);
+    return QString(errMsg);
+}
+
+static void openInput(AVFormatContext** const inCtx, const QString& path) {
+    const QByteArray pathBA = path.toUtf8();
+    const int openRet = avformat_open_input(inCtx, pathBA.data(),
+                                            nullptr, nullptr);
+    if(openRet < 0) RuntimeThrow("Could not open " + path + "\n" +
+                                 avErrorString(openRet));
+    const int infoRet = avformat_find_stream_info(*inCtx, nullptr);
+    if(infoRet < 0) RuntimeThrow("Could not find stream info in " + path +
+                                 "\n" + avErrorString(infoRet));
+}
+
+static void openOutput(AVFormatContext * const outCtx,
+                       AVFormatContext * const inCtx,
+                       const QByteArray& dstPath) {
+    for(uint i = 0; i < inCtx->nb_streams; i++) {
+        const auto inStream = inCtx->streams[i];
+        const auto outStream = avformat_new_stream(outCtx, nullptr);
+        if(!outStream) RuntimeThrow("Could not alloc stream");
+        const int parRet = avcodec_parameters_copy(outStream->codecpar,
+                                                   inStream->codecpar);
+        if(parRet < 0) RuntimeThrow("Could not copy the stream parameters\n" +
+                                    avErrorString(parRet));
+        outStream->codecpar->codec_tag = 0;
+        outStream->time_base = inStream->time_base;
+    }
+    if(!(outCtx->oformat->flags & AVFMT_NOFILE)) {
+        const int avioRet = avio_open(&outCtx->pb, dstPath.data(),
+                                      AVIO_FLAG_WRITE);
+        if(avioRet < 0) RuntimeThrow("Could not open " + dstPath.data() +
+                                     "\n" + avErrorString(avioRet));
+    }
+    const int whRet = avformat_write_header(outCtx, nullptr);
+    if(whRet < 0) RuntimeThrow("Could not write header to " + dstPath.data() +
+                               "\n" + avErrorString(whRet));
+}
+
+static void checkStreamsMatch(AVFormatContext * const outCtx,
+                              AVFormatContext * const inCtx,
+                              const QString& path) {
+    bool match = inCtx->nb_streams == outCtx->nb_streams;
+    for(uint i = 0; match && i < inCtx->nb_streams; i++) {
+        const auto inPar = inCtx->streams[i]->codecpar;
+        const auto outPar = outCtx->streams[i]->codecpar;
+        match = inPar->codec_type == outPar->codec_type &&
+                inPar->codec_id == outPar->codec_id;
+    }
+    if(!match) RuntimeThrow("Streams in " + path +
+                            " do not match the first segment");
+}
+
+static void copyPackets(AVFormatContext * const outCtx,
+                        AVFormatContext * const inCtx,
+                        const int64_t offset, const AVRational& offsetTb,
+                        QVector<int64_t>& lastDts) {
+    // the first timestamp of each stream, a segment starts at it
+    // instead of at zero because of the encoder delay
+    QVector<int64_t> segmentStart(int(inCtx->nb_streams), AV_NOPTS_VALUE);
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    while(true) {
+        const int readRet = av_read_frame(inCtx, &pkt);
+        if(readRet == AVERROR_EOF) break;
+        if(readRet < 0) RuntimeThrow("Error while reading packet\n" +
+                                     avErrorString(readRet));
+        const int index = pkt.stream_index;
+        const auto inStream = inCtx->streams[index];
+        const auto outStream = outCtx->streams[index];
+        av_packet_rescale_ts(&pkt, inStream->time_base, outStream->time_base);
+        auto& start = segmentStart[index];
+        if(start == AV_NOPTS_VALUE) {
+            start = pkt.dts != AV_NOPTS_VALUE ? pkt.dts : pkt.pts;
+            if(start == AV_NOPTS_VALUE) start = 0;
+        }
+        const int64_t streamOffset = av_rescale_q(offset, offsetTb,
+                                                  outStream->time_base) - start;
+        if(pkt.pts != AV_NOPTS_VALUE) pkt.pts += streamOffset;
+        if(pkt.dts != AV_NOPTS_VALUE) pkt.dts += streamOffset;
+        auto& last = lastDts[index];
+        if(pkt.dts != AV_NOPTS_VALUE) {
+            if(last != AV_NOPTS_VALUE && pkt.dts <= last) {
+                av_packet_unref(&pkt);
+                RuntimeThrow("Segment timestamps overlap the previous "
+                             "segment in stream " + QString::number(index));
+            }
+            last = pkt.dts;
+        }
+        pkt.pos = -1;
+        const int writeRet = av_interleaved_write_frame(outCtx, &pkt);
+        av_packet_unref(&pkt);
+        if(writeRet < 0) RuntimeThrow("Error while writing packet\n" +
+                                      avErrorString(writeRet));
+    }
+}
+
+static void closeOutput(AVFormatContext*& outCtx) {
+    if(!outCtx) return;
+    if(!(outCtx->oformat->flags & AVFMT_NOFILE)) avio_closep(&outCtx->pb);
+    avformat_free_context(outCtx);
+    outCtx = nullptr;
+}
+
+void SegmentMerger::sMerge(const QList<OutputSegment>& segments,
+                           const AVRational& frameDuration,
+                           const QString& dst) {
+    if(segments.isEmpty()) RuntimeThrow("No segments to merge");
+    const QByteArray dstPath = dst.toUtf8();
+    AVFormatContext* outCtx = nullptr;
+    const int allocRet = avformat_alloc_output_context2(
+                &outCtx, nullptr, nullptr, dstPath.data());
+    if(allocRet < 0 || !outCtx)
+        RuntimeThrow("Could not deduce output format from " + dst);
+    AVFormatContext* inCtx = nullptr;
+    QVector<int64_t> lastDts;
+    try {
+        for(const auto& segment : segments) {
+            openInput(&inCtx, segment.fPath);
+            if(lastDts.isEmpty()) {
+                openOutput(outCtx, inCtx, dstPath);
+                lastDts.fill(AV_NOPTS_VALUE, int(inCtx->nb_streams));
+            } else checkStreamsMatch(outCtx, inCtx, segment.fPath);
+            copyPackets(outCtx, inCtx, segment.fFrameOffset,
+                        frameDuration, lastDts);
+            avformat_close_input(&inCtx);
+        }
+        const int trailerRet = av_write_trailer(outCtx);
+        if(trailerRet < 0) RuntimeThrow("Could not write trailer\n" +
+                                        avErrorString(trailerRet));
+    } catch(...) {
+        avformat_close_input(&inCtx);
+        closeOutput(outCtx);
+        RuntimeThrow("Failed to merge segments into " + dst);
+    }
+    closeOutput(outCtx);
+}
@@ -0,0 +1,45 @@
+// enve - 2D animations software
+// Copyright (C) 2016-2020 Maurycy Liebner
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SEGMENTMERGER_H
+#define SEGMENTMERGER_H
+
+#include <QString>
+#include <QList>
+
+extern "C" {
+    #include <libavformat/avformat.h>
+}
+
+struct OutputSegment {
+    QString fPath;
+    // position of the segment in the merged output,
+    // in units of the frame duration passed to SegmentMerger::sMerge
+    int fFrameOffset;
+};
+
+// Concatenates segments rendered with identical output settings
+// into one container, packets are copied without re-encoding.
+// Each stream of a segment is rebased so that its first timestamp
+// lands on the segment frame offset.
+class SegmentMerger {
+public:
+    static void sMerge(const QList<OutputSegment>& segments,
+                       const AVRational& frameDuration,
+                       const QString& dst);
+};
+
+#endif // SEGMENTMERGER_H
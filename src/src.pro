@@ -17,11 +17,15 @@
 TEMPLATE = subdirs
 
 SUBDIRS = app \
+          benchmarks \
           colorwidgetshaders \
           core \
+          render \
           shaders
 
 colorwidgetshaders.subdir = app/GUI/ColorWidgets/colorwidgetshaders
 shaders.subdir = core/shaders
 
-app.depends = core
\ No newline at end of file
+app.depends = core
+benchmarks.depends = core
+render.depends = core
\ No newline at end of file